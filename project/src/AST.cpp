@@ -2,14 +2,58 @@
 
 using namespace std ;
 
-string Root::unparse() {
-	return varName->unparse() + " () {\n" + stmts->unparse() + "}\n";
+static const char *typeSpellings[] = { "", "Int", "Float", "Bool", "Str", "Matrix" } ;
+static const char *cppTypeNames[] = { "", "int", "float", "bool", "string", "Matrix" } ;
+
+exprType typeNamed(const string &keyword) {
+	for (int t = intType; t <= matrixType; t++)
+		if (keyword == typeSpellings[t])
+			return (exprType) t;
+	return unknownType;
+}
+
+const char *typeSpelling(exprType t) {
+	return typeSpellings[t];
+}
+
+const char *cppTypeName(exprType t) {
+	return cppTypeNames[t];
+}
+
+static const char *binaryOpSpellings[numBinaryOps] = {
+	"+", "-", "*", "/", "<", "<=", ">", ">=", "==", "!="
+};
+
+const char *binaryOpSpelling(binaryOp op) {
+	return binaryOpSpellings[op];
+}
+
+binaryOp binaryOpNamed(const string &s) {
+	for (int op = 0; op < numBinaryOps; op++)
+		if (s == binaryOpSpellings[op])
+			return (binaryOp) op;
+	return numBinaryOps;
+}
+
+string Node::unparse() {
+	Emitter out;
+	emitUnparse(out);
+	return out.take();
+}
+
+string Node::cppCode() {
+	Emitter out;
+	emitCppCode(out);
+	return out.take();
+}
+
+void Root::emitUnparse(Emitter &out) {
+	varName->emitUnparse(out); out << " () {\n"; stmts->emitUnparse(out); out << "}\n";
 }
 
-string Root::cppCode() {
-	string s = "#include <iostream>\n#include \"Matrix.h\"\n#include <math.h>\nusing namespace std;\n\n";
-	s += varName->cppCode() + " () {\n" + stmts->cppCode() + "}\n";
-	return s;
+void Root::emitCppCode(Emitter &out) {
+	out << "#include <iostream>\n#include \"Matrix.h\"\n#include <math.h>\nusing namespace std;\n\n";
+	varName->emitCppCode(out); out << " () {\n"; stmts->emitCppCode(out); out << "}\n";
 }
 ////////////////////////////////////////////////
 //
@@ -17,20 +61,14 @@ string Root::cppCode() {
 //
 ////////////////////////////////////////////////
 
-string EmptyStmts::unparse() {
-	return "";
-}
-
-string EmptyStmts::cppCode() {
-	return "";
-}
-
-string StmtStmts::unparse() {
-	return stmt->unparse() + stmts->unparse();
+void StmtList::emitUnparse(Emitter &out) {
+	for (size_t i = 0; i < stmts.size(); i++)
+		stmts[i]->emitUnparse(out);
 }
 
-string StmtStmts::cppCode() {
-	return stmt->cppCode() + stmts->cppCode();
+void StmtList::emitCppCode(Emitter &out) {
+	for (size_t i = 0; i < stmts.size(); i++)
+		stmts[i]->emitCppCode(out);
 }
 
 ////////////////////////////////////////////////
@@ -39,123 +77,118 @@ string StmtStmts::cppCode() {
 //
 ////////////////////////////////////////////////
 
-string StandardDecl::unparse() {
-	return typeKeyword + " " + varName->unparse() + ";\n";
-}
-
-string StandardDecl::cppCode() {
-	// It would be easier if there were an easy method
-	// to lowercase a string, but this is simple enought
-	// and also handles Str -> string. So oh well.
-	if (typeKeyword == "Int") {
-		return "int " + varName->cppCode() + ";\n";
-	} else if (typeKeyword == "Float") {
-		return "float " + varName->cppCode() + ";\n";
-	} else if (typeKeyword == "Str") {
-		return "string " + varName->cppCode() + ";\n";
-	} else if (typeKeyword == "Bool") {
-		return "bool " + varName->cppCode() + ";\n";
-	} else {
-		return "Unsupported Type";
+void StandardDecl::emitUnparse(Emitter &out) {
+	out << typeKeyword << " "; varName->emitUnparse(out); out << ";\n";
+}
+
+void StandardDecl::emitCppCode(Emitter &out) {
+	// The type keyword was looked up once, when the node was made.
+	if (declType == unknownType || declType == matrixType) {
+		out << "Unsupported Type";
+		return;
 	}
+	out << cppTypeName(declType) << " "; varName->emitCppCode(out); out << ";\n";
 }
 
-string MatrixAdvDecl::unparse() {
-	string s = "";
-	s += "Matrix " + varName1->unparse() + " [ " + expr1->unparse() + "," + expr2->unparse() + "] ";
-	s += varName2->unparse() + " , " + varName3->unparse() + " = " + expr3->unparse() + ";\n";
-	return s;
+void MatrixAdvDecl::emitUnparse(Emitter &out) {
+	out << "Matrix "; varName1->emitUnparse(out); out << " [ "; expr1->emitUnparse(out);
+	out << ","; expr2->emitUnparse(out); out << "] ";
+	varName2->emitUnparse(out); out << " , "; varName3->emitUnparse(out);
+	out << " = "; expr3->emitUnparse(out); out << ";\n";
 }
 
-string MatrixAdvDecl::cppCode() {
-	string returnString = "Matrix " + varName1->cppCode() + "(" + expr1->cppCode() + "," + expr2->cppCode() + ");\n";
-	returnString += "for (int " + varName2->cppCode() + " = 0; " + varName2->cppCode() + " < " + expr1->cppCode() + "; " + varName2->cppCode() + "++ ) {\n";
-    returnString += "\tfor (int " + varName3->cppCode() + " = 0; " + varName3->cppCode() + " < " + expr2->cppCode() + "; " + varName3->cppCode() + "++ ) {\n";
-    returnString += "\t\t*(" + varName1->cppCode() + ".access(" + varName2->cppCode() + ", " + varName3->cppCode() + ")) = " + expr3->cppCode() + ";\n";
-    returnString += "\t}\n";
-    returnString += "}\n";
-    return returnString;
+void MatrixAdvDecl::emitCppCode(Emitter &out) {
+	out << "Matrix "; varName1->emitCppCode(out); out << "(";
+	expr1->emitCppCode(out); out << ","; expr2->emitCppCode(out); out << ");\n";
+	out << "for (int "; varName2->emitCppCode(out); out << " = 0; "; varName2->emitCppCode(out);
+	out << " < "; expr1->emitCppCode(out); out << "; "; varName2->emitCppCode(out); out << "++ ) {\n";
+	out << "\tfor (int "; varName3->emitCppCode(out); out << " = 0; "; varName3->emitCppCode(out);
+	out << " < "; expr2->emitCppCode(out); out << "; "; varName3->emitCppCode(out); out << "++ ) {\n";
+	out << "\t\t*("; varName1->emitCppCode(out); out << ".access("; varName2->emitCppCode(out);
+	out << ", "; varName3->emitCppCode(out); out << ")) = "; expr3->emitCppCode(out); out << ";\n";
+	out << "\t}\n";
+	out << "}\n";
 }
 
-string MatrixDecl::unparse() {
-	return "Matrix " + varName->unparse() + " = " + expr->unparse() + ";\n";
+void MatrixDecl::emitUnparse(Emitter &out) {
+	out << "Matrix "; varName->emitUnparse(out); out << " = "; expr->emitUnparse(out); out << ";\n";
 }
 
-string MatrixDecl::cppCode() {
+void MatrixDecl::emitCppCode(Emitter &out) {
 	// Need to create a matrix class before this can be done
-	return "Matrix " + varName->cppCode() + " = Matrix::"  + expr->cppCode() + ";\n"; 
+	out << "Matrix "; varName->emitCppCode(out); out << " = Matrix::"; expr->emitCppCode(out); out << ";\n";
 }
 
-string StmtBlock::unparse() {
-	return "{\n" + stmts->unparse() + "}";
+void StmtBlock::emitUnparse(Emitter &out) {
+	out << "{\n"; stmts->emitUnparse(out); out << "}";
 }
 
-string StmtBlock::cppCode() {
-	return "{\n" + stmts->cppCode() + "}";
+void StmtBlock::emitCppCode(Emitter &out) {
+	out << "{\n"; stmts->emitCppCode(out); out << "}";
 }
 
-string IfStmt::unparse() {
-	return "if ( " + expr->unparse() + " ) " + stmt->unparse();
+void IfStmt::emitUnparse(Emitter &out) {
+	out << "if ( "; expr->emitUnparse(out); out << " ) "; stmt->emitUnparse(out);
 }
 
-string IfStmt::cppCode() {
-	return "if ( " + expr->cppCode() + " ) " + stmt->cppCode();
+void IfStmt::emitCppCode(Emitter &out) {
+	out << "if ( "; expr->emitCppCode(out); out << " ) "; stmt->emitCppCode(out);
 }
 
-string IfElseStmt::unparse() {
-	string s = "";
-	s+= "if (" + expr->unparse() + ") " + stmt1->unparse();
-	s+= " else " + stmt2->unparse() + "\n";
-	return s;
+void IfElseStmt::emitUnparse(Emitter &out) {
+	out << "if ("; expr->emitUnparse(out); out << ") "; stmt1->emitUnparse(out);
+	out << " else "; stmt2->emitUnparse(out); out << "\n";
 }
 
-string IfElseStmt::cppCode() {
-	string s = "";
-	s+= "if (" + expr->cppCode() + ") " + stmt1->cppCode();
-	s+= " else " + stmt2->cppCode() + "\n";
-	return s;
+void IfElseStmt::emitCppCode(Emitter &out) {
+	out << "if ("; expr->emitCppCode(out); out << ") "; stmt1->emitCppCode(out);
+	out << " else "; stmt2->emitCppCode(out); out << "\n";
 }
 
-string StandardAssignStmt::unparse() {
-	return varName->unparse() + " = " + expr->unparse() + ";\n";
+void StandardAssignStmt::emitUnparse(Emitter &out) {
+	varName->emitUnparse(out); out << " = "; expr->emitUnparse(out); out << ";\n";
 }
 
-string StandardAssignStmt::cppCode() {
-	return varName->cppCode() + " = " + expr->cppCode() + ";\n";
+void StandardAssignStmt::emitCppCode(Emitter &out) {
+	varName->emitCppCode(out); out << " = "; expr->emitCppCode(out); out << ";\n";
 }
 
-string MatrixAssignStmt::unparse() {
-	return varName->unparse() + "[" + expr1->unparse() + "," + expr2->unparse() + "] = " + expr3->unparse() + ";\n" ;
+void MatrixAssignStmt::emitUnparse(Emitter &out) {
+	varName->emitUnparse(out); out << "["; expr1->emitUnparse(out); out << ",";
+	expr2->emitUnparse(out); out << "] = "; expr3->emitUnparse(out); out << ";\n";
 }
 
-string MatrixAssignStmt::cppCode() {
-	return "*(" + varName->cppCode() + ".access(" + expr1->cppCode() + ", " + expr2->cppCode() + ")) = " + expr3->cppCode() + ";\n";
+void MatrixAssignStmt::emitCppCode(Emitter &out) {
+	out << "*("; varName->emitCppCode(out); out << ".access("; expr1->emitCppCode(out);
+	out << ", "; expr2->emitCppCode(out); out << ")) = "; expr3->emitCppCode(out); out << ";\n";
 }
 
-string PrintStmt::unparse() {
-	return "print(" + expr->unparse() + ");\n";
+void PrintStmt::emitUnparse(Emitter &out) {
+	out << "print("; expr->emitUnparse(out); out << ");\n";
 }
 
-string PrintStmt::cppCode() {
-	return "cout << " + expr->cppCode() + ";\n";
+void PrintStmt::emitCppCode(Emitter &out) {
+	out << "cout << "; expr->emitCppCode(out); out << ";\n";
 }
 
-string ForStmt::unparse() {
-	return "for(" + varName->unparse() + "=" + expr1->unparse() + " : " + expr2->unparse() + ")" + stmt->unparse() + "\n";
+void ForStmt::emitUnparse(Emitter &out) {
+	out << "for("; varName->emitUnparse(out); out << "="; expr1->emitUnparse(out);
+	out << " : "; expr2->emitUnparse(out); out << ")"; stmt->emitUnparse(out); out << "\n";
 }
 
-string ForStmt::cppCode() {
-	string returnString = "for(" + varName->cppCode() + "=" + expr1->cppCode() + "; " + varName->cppCode();
-	returnString += " <= " + expr2->cppCode() + "; " + varName->cppCode() + " ++)" + stmt->cppCode() + "\n";
-	return returnString;
+void ForStmt::emitCppCode(Emitter &out) {
+	out << "for("; varName->emitCppCode(out); out << "="; expr1->emitCppCode(out);
+	out << "; "; varName->emitCppCode(out);
+	out << " <= "; expr2->emitCppCode(out); out << "; "; varName->emitCppCode(out);
+	out << " ++)"; stmt->emitCppCode(out); out << "\n";
 }
 
-string WhileStmt::unparse() {
-	return "while(" + expr->unparse() + ")" + stmt->unparse() + "\n";
+void WhileStmt::emitUnparse(Emitter &out) {
+	out << "while("; expr->emitUnparse(out); out << ")"; stmt->emitUnparse(out); out << "\n";
 }
 
-string WhileStmt::cppCode() {
-	return "while(" + expr->cppCode() + ")" + stmt->cppCode() + "\n";
+void WhileStmt::emitCppCode(Emitter &out) {
+	out << "while("; expr->emitCppCode(out); out << ")"; stmt->emitCppCode(out); out << "\n";
 }
 
 ////////////////////////////////////////////////
@@ -164,80 +197,123 @@ string WhileStmt::cppCode() {
 //
 ////////////////////////////////////////////////
 
-string VarName::unparse() { 
-	return lexeme;
+void VarName::emitUnparse(Emitter &out) {
+	out << lexeme;
 }
 
-string VarName::cppCode() { 
-	return lexeme;
+void VarName::emitCppCode(Emitter &out) {
+	out << lexeme;
 }
 
-string AnyConst::unparse() {
-	return constString;
+void AnyConst::emitUnparse(Emitter &out) {
+	out << constString;
 }
 
-string AnyConst::cppCode() {
-	return constString;
+void AnyConst::emitCppCode(Emitter &out) {
+	// Once typed, a Float literal is written as a C++ float, not a
+	// double, and a Bool one as C++ true or false.
+	switch (type()) {
+	case floatType:
+		out << constString;
+		if (constString.find('.') == string::npos)
+			out << ".0";
+		out << 'f';
+		break;
+	case boolType:
+		out << (constString == "True" ? "true" : "false");
+		break;
+	default:
+		out << constString;
+	}
 }
 
-string BinOpExpr::unparse() {
-	return left->unparse() + " " + op + " " + right->unparse();
+/* A chain such as a + b + c is a BinOpExpr whose left operand is
+   another, and so on down.  It is written with a loop, not by
+   recursion down the left operands, so that a long chain takes no
+   more stack than a short one.
+ */
+static Expr *leftSpine(BinOpExpr *e, vector<BinOpExpr *> &spine) {
+	Expr *x = e->left;
+	while (x->kind() == binOpExprNode) {
+		spine.push_back(static_cast<BinOpExpr *>(x));
+		x = spine.back()->left;
+	}
+	return x;
 }
 
-string BinOpExpr::cppCode() {
-	return left->cppCode() + " " + op + " " + right->cppCode();
+void BinOpExpr::emitUnparse(Emitter &out) {
+	vector<BinOpExpr *> spine;
+	leftSpine(this, spine)->emitUnparse(out);
+	for (size_t i = spine.size(); i-- > 0; ) {
+		out << " " << spine[i]->op << " "; spine[i]->right->emitUnparse(out);
+	}
+	out << " " << op << " "; right->emitUnparse(out);
 }
-	
-string MatrixRefExpr::unparse() {
-	return varName->unparse() + "[" + expr1->unparse() + "," + expr2->unparse() + "]";
+
+void BinOpExpr::emitCppCode(Emitter &out) {
+	vector<BinOpExpr *> spine;
+	leftSpine(this, spine)->emitCppCode(out);
+	for (size_t i = spine.size(); i-- > 0; ) {
+		out << " " << spine[i]->op << " "; spine[i]->right->emitCppCode(out);
+	}
+	out << " " << op << " "; right->emitCppCode(out);
+}
+
+void MatrixRefExpr::emitUnparse(Emitter &out) {
+	varName->emitUnparse(out); out << "["; expr1->emitUnparse(out); out << ",";
+	expr2->emitUnparse(out); out << "]";
 }
 
-string MatrixRefExpr::cppCode() {
-	return "*(" + varName->cppCode() + ".access(" + expr1->cppCode() + "," + expr2->cppCode() + "))";
+void MatrixRefExpr::emitCppCode(Emitter &out) {
+	out << "*("; varName->emitCppCode(out); out << ".access("; expr1->emitCppCode(out);
+	out << ","; expr2->emitCppCode(out); out << "))";
 }
 
-string FunctionCall::unparse() {
-	return varName->unparse() + "(" + expr->unparse() + ")";
+void FunctionCall::emitUnparse(Emitter &out) {
+	varName->emitUnparse(out); out << "("; expr->emitUnparse(out); out << ")";
 }
 
-string FunctionCall::cppCode() {
-	string args = expr->cppCode();
-	if (args == "data") {
-		return expr->cppCode() + "." + varName->cppCode() + "()";
+void FunctionCall::emitCppCode(Emitter &out) {
+	// Only a variable named data has C++ code "data".
+	VarName *arg = expr->asVarName();
+	if (arg && arg->name() == "data") {
+		expr->emitCppCode(out); out << "."; varName->emitCppCode(out); out << "()";
 	} else {
-		return varName->cppCode() + "(" + expr->cppCode() + ")";
+		varName->emitCppCode(out); out << "("; expr->emitCppCode(out); out << ")";
 	}
 }
 
-string ParensExpr::unparse() {
-	return "(" + expr->unparse() + ")";
+void ParensExpr::emitUnparse(Emitter &out) {
+	out << "("; expr->emitUnparse(out); out << ")";
 }
 
-string ParensExpr::cppCode() {
-	return "(" + expr->cppCode() + ")";
+void ParensExpr::emitCppCode(Emitter &out) {
+	out << "("; expr->emitCppCode(out); out << ")";
 }
 
-string LetExpr::unparse() {
-	return "let " + stmts->unparse() + " in " + expr->unparse() + " end ";
+void LetExpr::emitUnparse(Emitter &out) {
+	out << "let "; stmts->emitUnparse(out); out << " in "; expr->emitUnparse(out); out << " end ";
 }
 
-string LetExpr::cppCode() {
-	return "({ " + stmts->cppCode() + expr->cppCode() + ";\n})";
+void LetExpr::emitCppCode(Emitter &out) {
+	out << "({ "; stmts->emitCppCode(out); expr->emitCppCode(out); out << ";\n})";
 }
 
-string IfExpr::unparse() {
-	return "if " + expr1->unparse() + " then " + expr2->unparse() + " else " + expr3->unparse();
+void IfExpr::emitUnparse(Emitter &out) {
+	out << "if "; expr1->emitUnparse(out); out << " then "; expr2->emitUnparse(out);
+	out << " else "; expr3->emitUnparse(out);
 }
 
-string IfExpr::cppCode() {
-	// C++ doesn't have if then else, so just using IfElseStmt::cppCode() 
-	return "(" + expr1->cppCode() + ") ? " + expr2->cppCode() + " : " + expr3->cppCode() + "\n";
+void IfExpr::emitCppCode(Emitter &out) {
+	// C++ doesn't have if then else, so just using IfElseStmt::cppCode()
+	out << "("; expr1->emitCppCode(out); out << ") ? "; expr2->emitCppCode(out);
+	out << " : "; expr3->emitCppCode(out); out << "\n";
 }
 
-string NotExpr::unparse() {
-	return "!" + expr->unparse();
+void NotExpr::emitUnparse(Emitter &out) {
+	out << "!"; expr->emitUnparse(out);
 }
 
-string NotExpr::cppCode() {
-	return "!" + expr->cppCode();
+void NotExpr::emitCppCode(Emitter &out) {
+	out << "!"; expr->emitCppCode(out);
 }
@@ -3,8 +3,11 @@
 
 #include <string>
 #include <iostream> 
+#include <vector>
+#include <stdint.h>
 
 #include "scanner.h"
+#include "emitter.h"
 
 // Abstract Classes
 class Node ;
@@ -14,8 +17,7 @@ class Stmt ;
 class Expr ;
 
 // Stmts Derivatives
-class EmptyStmts ;
-class StmtStmts ;
+class StmtList ;
 
 // Stmt Derivatives
 class StandardDecl ;
@@ -41,14 +43,95 @@ class LetExpr ;
 class IfExpr ;
 class NotExpr ;
 
+/*! \enum nodeKind
+	\brief The concrete class of a Node.
+
+	The kinds of each abstract class are contiguous, so whether a node
+	is a Stmt or an Expr is a range check on its kind.
+*/
+enum nodeKindEnumType {
+	rootNode,
+	stmtListNode,
+
+	// Stmt kinds
+	standardDeclNode, matrixAdvDeclNode, matrixDeclNode, stmtBlockNode,
+	ifStmtNode, ifElseStmtNode, standardAssignStmtNode, matrixAssignStmtNode,
+	printStmtNode, forStmtNode, whileStmtNode,
+
+	// Expr kinds
+	varNameNode, anyConstNode, binOpExprNode, matrixRefExprNode,
+	functionCallNode, parensExprNode, letExprNode, ifExprNode, notExprNode
+} ;
+typedef enum nodeKindEnumType nodeKind ;
+
+/*! \enum exprType
+	\brief The type of an Expr, as found by a TypeChecker (see
+	typeChecker.h).  Every Expr is of unknownType until one has run.
+*/
+enum exprTypeEnumType {
+	unknownType, intType, floatType, boolType, strType, matrixType
+} ;
+typedef enum exprTypeEnumType exprType ;
+
+// The exprType of a type keyword ("Int", "Float", ...), or unknownType,
+// and the keyword and the C++ type of each exprType.
+exprType typeNamed ( const std::string &keyword ) ;
+const char *typeSpelling ( exprType t ) ;
+const char *cppTypeName ( exprType t ) ;
+
+/*! \enum binaryOp
+	\brief The operators of a BinOpExpr, which holds the spelling.
+*/
+enum binaryOpEnumType {
+	addOp, subOp, mulOp, divOp,
+	lessOp, lessEqualOp, greaterOp, greaterEqualOp, equalOp, notEqualOp,
+	numBinaryOps
+} ;
+typedef enum binaryOpEnumType binaryOp ;
+
+// The spelling of each binaryOp, and the binaryOp spelled [s], or
+// numBinaryOps.
+const char *binaryOpSpelling ( binaryOp op ) ;
+binaryOp binaryOpNamed ( const std::string &s ) ;
+
 /*! \class Node
 	\brief Abstract parent or grandparent for all classes in the Abstract Syntax Tree (AST)
+
+	Every Node records its nodeKind, so code that needs to know what a
+	Node is can compare an integer instead of using dynamic_cast.  The
+	as* accessors return NULL when the Node is not of that class.
+
+	The children and values of every class are public, so that passes
+	over the tree (see visitor.h) can read and replace them.
 */
 class Node {
 public:
-	virtual std::string unparse ( ) = 0 ;
-	virtual std::string cppCode ( ) = 0 ;
+	// The code of this node and all below it, as FCAL and as C++.
+	// Each writes all of its output to one Emitter.  They recurse
+	// once per level of nesting, but walk a list of statements and
+	// a chain of operators such as a + b + c with a loop.
+	std::string unparse ( ) ;
+	std::string cppCode ( ) ;
+	virtual void emitUnparse ( Emitter &out ) = 0 ;
+	virtual void emitCppCode ( Emitter &out ) = 0 ;
 	virtual ~Node() { } ;
+
+	nodeKind kind ( ) const { return (nodeKind) kindTag ; }
+	bool isStmts ( ) const { return kindTag == stmtListNode ; }
+	bool isStmt ( ) const { return kindTag >= standardDeclNode && kindTag <= whileStmtNode ; }
+	bool isExpr ( ) const { return kindTag >= varNameNode && kindTag <= notExprNode ; }
+
+	Stmts *asStmts ( ) ;
+	Stmt *asStmt ( ) ;
+	Expr *asExpr ( ) ;
+	VarName *asVarName ( ) ;
+	Root *asRoot ( ) ;
+
+protected:
+	Node(nodeKind k) : kindTag(k) {};
+
+private:
+	unsigned char kindTag ;
 } ;
 
 /*! \class Root
@@ -63,20 +146,16 @@ public:
 	    @param v - Name of root
 	    @param s - Stmts in body of root
 	*/
-	Root(VarName *v, Stmts *s) : varName(v),stmts(s){};
+	Root(VarName *v, Stmts *s) : Node(rootNode), varName(v),stmts(s){};
 
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
+	void emitUnparse(Emitter &out);
 
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
-private:
+	void emitCppCode(Emitter &out);
 	VarName *varName;
 	Stmts *stmts;
 };
@@ -85,66 +164,49 @@ private:
 /*! \class Stmts
  *	\brief Parent for all statements to be parsed
  */
-class Stmts : public Node {};
-
-/*! \class EmptyStmts
- 	\brief Represents emptiness
- 
-	Model: Stmts ::= <<empty>> <BR>
-	Example: <<emptiness>>
-*/
-class EmptyStmts : public Stmts {
-public:
-	/*! Public constructor. 
-	*/	
-	EmptyStmts(){};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
-	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
-	 */
-	 std::string cppCode();
+class Stmts : public Node {
+protected:
+	Stmts(nodeKind k) : Node(k) {};
 };
 
-/*! \class StmtStmts 
-    \brief This provides a gateway to stmt objects. Without this, there would only be  <BR>
-		   Stmts and no Stmt would be able to be parsed.
+/*! \class StmtList
+ 	\brief A sequence of statements, kept in order in one vector.
 
-	MODEL: Stmts ::= Stmt Stmts <BR>
-	Example: x = 1; <<empty>>
+	The parser fills it with a loop, and unparse and cppCode walk it
+	with a loop, so a long sequence needs no more stack than a short
+	one.
+
+	Model: Stmts ::= Stmt Stmts | <<empty>> <BR>
+	Example: x = 1; y = 2;
 */
-class StmtStmts : public Stmts {
+class StmtList : public Stmts {
 public:
-	/*! Public constructor.
-	    @param _stmt  - Single statement
-	    @param _stmts - Further statements
+	/*! Public constructor. 
+	*/	
+	StmtList() : Stmts(stmtListNode) {};
+	/*! Adds a statement to the end of the list.
+	    @param s - Statement to append
 	*/
-	StmtStmts(Stmt *_stmt, Stmts *_stmts) : stmt(_stmt), stmts(_stmts) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	void append(Stmt *s) { stmts.push_back(s); }
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
-	Stmt *stmt;
-	Stmts *stmts;
+	std::vector<Stmt *> stmts;
 };
 		
 
 /*! \class Stmt 
     \brief Parent for all statment instances to be parsed <BR>
 */	
-class Stmt : public Node {};
+class Stmt : public Node {
+protected:
+	Stmt(nodeKind k) : Node(k) {};
+};
 
 /*! \class StandardDecl
     \brief Represents a declaration of a variable <BR>
@@ -158,20 +220,17 @@ public:
 	    @param tKwd - Keyword ie "Int", "Float", etc
 	    @param v - Name of variable being declared
 	*/
-	StandardDecl(std::string tKwd, VarName *v) : typeKeyword(tKwd), varName(v) {}; 
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	StandardDecl(std::string tKwd, VarName *v) : Stmt(standardDeclNode), typeKeyword(tKwd), declType(typeNamed(tKwd)), varName(v) {}; 
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	std::string typeKeyword;
+	exprType declType;
 	VarName *varName;
 };
 
@@ -192,19 +251,15 @@ public:
 	    @param e3 - Expr for value to  be assigned
 	*/
 	MatrixAdvDecl(VarName* v1, VarName* v2, VarName* v3, Expr* e1, Expr* e2, Expr* e3) 
-	: varName1(v1), varName2(v2), varName3(v3), expr1(e1), expr2(e2), expr3(e3) {}; 
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	: Stmt(matrixAdvDeclNode), varName1(v1), varName2(v2), varName3(v3), expr1(e1), expr2(e2), expr3(e3) {}; 
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	VarName *varName1;
 	VarName *varName2;
 	VarName *varName3;
@@ -225,19 +280,15 @@ public:
 	    @param v - Name of matrix being constructed
 	    @param e - Expr of value being assigned
 	*/
-	MatrixDecl(VarName* v, Expr* e) : varName(v), expr(e) {}; 
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	MatrixDecl(VarName* v, Expr* e) : Stmt(matrixDeclNode), varName(v), expr(e) {}; 
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	VarName *varName;
 	Expr* expr;
 };
@@ -254,19 +305,15 @@ public:
 	    @param v - Name of matrix being constructed
 	    @param e - Expr of value being assigned
 	*/
-    StmtBlock(Stmts* s): stmts(s) {};
-    /** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
-	 */
-    std::string unparse();
-    /** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
-	 */
-	 std::string cppCode();
+    StmtBlock(Stmts* s): Stmt(stmtBlockNode), stmts(s) {};
+    /** @brief Writes the code modeled by this class and
+     *         all its variables.
+     */
+    void emitUnparse(Emitter &out);
+    /** @brief Writes the FCAL code as C++ code.
+     */
+    void emitCppCode(Emitter &out);
 
-private:
     Stmts* stmts;
 } ;
 
@@ -282,19 +329,15 @@ public:
 	    @param e - Boolean expression that is evaluated by if
 	    @param s - Statement to be executed if true
 	*/
-	IfStmt(Expr* e, Stmt* s) : expr(e), stmt(s) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	IfStmt(Expr* e, Stmt* s) : Stmt(ifStmtNode), expr(e), stmt(s) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	Expr* expr;
 	Stmt* stmt;
 };
@@ -312,19 +355,15 @@ public:
 	    @param s1 - Statement to be executed if true
 	    @param s2 - Statement to be executed if false
 	*/
-	IfElseStmt(Expr* e, Stmt* s1, Stmt* s2) : expr(e), stmt1(s1), stmt2(s2) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	IfElseStmt(Expr* e, Stmt* s1, Stmt* s2) : Stmt(ifElseStmtNode), expr(e), stmt1(s1), stmt2(s2) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	Expr* expr;
 	Stmt* stmt1;
 	Stmt* stmt2;
@@ -342,18 +381,14 @@ public:
 	    @param v - Name of variable being assigned
 	    @param e - Expression of the value to be assigned
 	*/
-	StandardAssignStmt(VarName* v, Expr* e) : varName(v), expr(e) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	StandardAssignStmt(VarName* v, Expr* e) : Stmt(standardAssignStmtNode), varName(v), expr(e) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
-private:
+	void emitCppCode(Emitter &out);
 	VarName* varName;
 	Expr* expr;
 };
@@ -373,19 +408,15 @@ public:
 	    @param e3 - Expression of the value to be assigned
 	*/
 	MatrixAssignStmt(VarName* v, Expr* e1, Expr* e2, Expr* e3) 
-	: varName(v), expr1(e1), expr2(e2), expr3(e3) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	: Stmt(matrixAssignStmtNode), varName(v), expr1(e1), expr2(e2), expr3(e3) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	VarName* varName;
 	Expr* expr1;
 	Expr* expr2;
@@ -402,19 +433,15 @@ public:
 	/*! Public constructor. 
 	    @param e - Expression of what is to be printed
 	*/
-	PrintStmt(Expr* e) : expr(e) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	PrintStmt(Expr* e) : Stmt(printStmtNode), expr(e) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	Expr* expr;
 };
 
@@ -432,19 +459,15 @@ public:
 	    @param s  - Expression to be executed for each iteration
 	*/
     ForStmt(VarName* v, Expr* e1, Expr* e2, Stmt* s)
-    : varName(v), expr1(e1), expr2(e2), stmt(s) {};
-    /** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
-	 */
-    std::string unparse();
-    /** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
-	 */
-	 std::string cppCode();
+    : Stmt(forStmtNode), varName(v), expr1(e1), expr2(e2), stmt(s) {};
+    /** @brief Writes the code modeled by this class and
+     *         all its variables.
+     */
+    void emitUnparse(Emitter &out);
+    /** @brief Writes the FCAL code as C++ code.
+     */
+    void emitCppCode(Emitter &out);
 
-private:
     VarName* varName;
     Expr* expr1;
     Expr* expr2;
@@ -463,19 +486,15 @@ public:
 	    @param e - Expression to be evaluated for each iteration
 	    @param s - Expression to be executed for each iteration
 	*/
-	WhileStmt(Expr* e, Stmt* s) : expr(e), stmt(s) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	WhileStmt(Expr* e, Stmt* s) : Stmt(whileStmtNode), expr(e), stmt(s) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	Expr* expr;
 	Stmt* stmt;
 };
@@ -486,7 +505,15 @@ private:
 	Model: Expr ::= varName <BR>
 	Example: x
 */	
-class Expr : public Node {};
+class Expr : public Node {
+public:
+	exprType type() const { return (exprType) typeTag; }
+	void setType(exprType t) { typeTag = t; }
+protected:
+	Expr(nodeKind k) : Node(k), typeTag(unknownType) {};
+private:
+	unsigned char typeTag;
+};
 
 /*! \class VarName 
    \brief Represents a variable name. <BR>
@@ -499,19 +526,25 @@ public:
 	/*! Public constructor. 
 	    @param s - Name of variable
 	*/
-	VarName(std::string s) : lexeme(s) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	VarName(std::string s) : Expr(varNameNode), lexeme(s), nameId(unresolved), symbol(unresolved) {};
+	/*! The name of the variable.
+	*/
+	const std::string &name() const { return lexeme; }
+	/*! Set by a NameResolver (see symbolTable.h): the id of the name
+	    in its SymbolTable's StringPool, and the id of the Symbol the
+	    name refers to, or [unresolved].
+	*/
+	static const uint32_t unresolved = 0xFFFFFFFFu;
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
-private:
+	void emitCppCode(Emitter &out);
 	std::string lexeme;
+	uint32_t nameId;
+	uint32_t symbol;
 };
 
 /*! \class AnyConst 
@@ -525,18 +558,14 @@ public:
 	/*! Public constructor. 
 	    @param s - Value of the constant
 	*/
-	AnyConst(std::string s) :constString(s){};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	AnyConst(std::string s) :Expr(anyConstNode), constString(s){};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
-private:
+	void emitCppCode(Emitter &out);
 	std::string constString;
 };
 
@@ -554,18 +583,14 @@ public:
 	    @param R  - Expression on right-hand side of operation
 	*/
 	BinOpExpr(Expr* L, std::string op, Expr* R)
-	: left(L), op(op), right(R) {} ;
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	: Expr(binOpExprNode), left(L), op(op), right(R) {} ;
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
-private:
+	void emitCppCode(Emitter &out);
 	Expr *left;
 	std::string op;
 	Expr *right;
@@ -584,19 +609,15 @@ public:
 	    @param e1 - Expression of row being accessed
 	    @param e2 - Expression of col being accessed
 	*/
-	MatrixRefExpr(VarName* v, Expr* e1, Expr* e2) : varName(v), expr1(e1), expr2(e2) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	MatrixRefExpr(VarName* v, Expr* e1, Expr* e2) : Expr(matrixRefExprNode), varName(v), expr1(e1), expr2(e2) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	VarName* varName;
 	Expr* expr1;
 	Expr* expr2;	
@@ -614,19 +635,15 @@ public:
 	    @param v  - Name of function being called
 	    @param e  - Expression of arguments
 	*/
-	FunctionCall(VarName* v, Expr* e) : varName(v), expr(e) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	FunctionCall(VarName* v, Expr* e) : Expr(functionCallNode), varName(v), expr(e) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	VarName* varName;
 	Expr* expr;
 };
@@ -642,19 +659,15 @@ public:
 	/*! Public constructor. 
 	    @param e  - Expression evaluated inside the parenthesis
 	*/
-	ParensExpr(Expr* e) : expr(e) {};
-	/** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
+	ParensExpr(Expr* e) : Expr(parensExprNode), expr(e) {};
+	/** @brief Writes the code modeled by this class and
+	 *         all its variables.
 	 */
-	std::string unparse();
-	/** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
+	void emitUnparse(Emitter &out);
+	/** @brief Writes the FCAL code as C++ code.
 	 */
-	 std::string cppCode();
+	void emitCppCode(Emitter &out);
 
-private:
 	Expr* expr;
 };
 
@@ -670,19 +683,15 @@ public:
 		@param s - Statement to be considered
 	    @param e - Expression to be evaluated
 	*/
-    LetExpr(Stmts* s, Expr* e) : stmts(s), expr(e) {};
-    /** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
-	 */
-    std::string unparse();
-    /** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
-	 */
-	 std::string cppCode();
+    LetExpr(Stmts* s, Expr* e) : Expr(letExprNode), stmts(s), expr(e) {};
+    /** @brief Writes the code modeled by this class and
+     *         all its variables.
+     */
+    void emitUnparse(Emitter &out);
+    /** @brief Writes the FCAL code as C++ code.
+     */
+    void emitCppCode(Emitter &out);
 
-private:
     Stmts* stmts;
     Expr* expr;
 };
@@ -700,19 +709,15 @@ public:
 	    @param e2 - Expression to be evaluated if true
 	    @param e3 - Expression to be evaluated if false
 	*/
-    IfExpr(Expr* e1, Expr* e2, Expr* e3) : expr1(e1), expr2(e2), expr3(e3) {};
-    /** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
-	 */
-    std::string unparse();
-    /** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
-	 */
-	 std::string cppCode();
+    IfExpr(Expr* e1, Expr* e2, Expr* e3) : Expr(ifExprNode), expr1(e1), expr2(e2), expr3(e3) {};
+    /** @brief Writes the code modeled by this class and
+     *         all its variables.
+     */
+    void emitUnparse(Emitter &out);
+    /** @brief Writes the FCAL code as C++ code.
+     */
+    void emitCppCode(Emitter &out);
 
-private:
     Expr* expr1;
     Expr* expr2;
     Expr* expr3;
@@ -729,21 +734,24 @@ public:
 	/*! Public constructor. 
 		@param e - Boolean expression being negated 
 	*/
-    NotExpr(Expr* e) : expr(e) {};
-    /** @brief Returns a string representation of the code
-	 *         modeled by this class and all its variables.
-	 *  @return std::string.
-	 */
-    std::string unparse();
-    /** @brief Returns a string representation of the FCAL
-	 *  	   code in C++ code.
-	 *	@return std::string.
-	 */
-	 std::string cppCode();
+    NotExpr(Expr* e) : Expr(notExprNode), expr(e) {};
+    /** @brief Writes the code modeled by this class and
+     *         all its variables.
+     */
+    void emitUnparse(Emitter &out);
+    /** @brief Writes the FCAL code as C++ code.
+     */
+    void emitCppCode(Emitter &out);
 
-private:
     Expr* expr;
 };
 
+/* The as* accessors are defined here, where every class is complete. */
+inline Stmts *Node::asStmts ( ) { return isStmts() ? static_cast<Stmts *>(this) : NULL ; }
+inline Stmt *Node::asStmt ( ) { return isStmt() ? static_cast<Stmt *>(this) : NULL ; }
+inline Expr *Node::asExpr ( ) { return isExpr() ? static_cast<Expr *>(this) : NULL ; }
+inline VarName *Node::asVarName ( ) { return kindTag == varNameNode ? static_cast<VarName *>(this) : NULL ; }
+inline Root *Node::asRoot ( ) { return kindTag == rootNode ? static_cast<Root *>(this) : NULL ; }
+
 #endif
 
@@ -0,0 +1,83 @@
+/* arena.cpp
+
+   This file provides the [Arena] class.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+Arena::Arena (size_t blockSize) : blockSize(blockSize), first(NULL), current(NULL),
+    next(NULL), end(NULL), finalizers(NULL), objects(0), used(0), blocks(0) { }
+
+Arena::~Arena () {
+    release () ;
+    while (first != NULL) {
+        Block *b = first ;
+        first = b->next ;
+        free (b) ;
+    }
+}
+
+/* Moves on to a block with room for at least [minSize] bytes after the
+   header and any alignment padding: the next block kept from before a
+   release if it is big enough, or else a new one.  An object larger
+   than a block gets a block of its own.
+ */
+void Arena::nextBlock (size_t minSize) {
+    Block *b = current ? current->next : first ;
+    if (b == NULL || b->size < sizeof (Block) + minSize) {
+        size_t size = sizeof (Block) + minSize ;
+        if (size < blockSize)
+            size = blockSize ;
+        Block *nb = (Block *) malloc (size) ;
+        if (nb == NULL)
+            throw std::bad_alloc () ;
+        nb->next = b ;
+        nb->size = size ;
+        if (current)
+            current->next = nb ;
+        else
+            first = nb ;
+        blocks ++ ;
+        b = nb ;
+    }
+    current = b ;
+    next = (char *) (b + 1) ;
+    end = (char *) b + b->size ;
+}
+
+void *Arena::allocate (size_t size, size_t align) {
+    uintptr_t p = ((uintptr_t) next + align - 1) & ~(uintptr_t) (align - 1) ;
+    if (current == NULL || p + size > (uintptr_t) end) {
+        nextBlock (size + align) ;
+        p = ((uintptr_t) next + align - 1) & ~(uintptr_t) (align - 1) ;
+    }
+    next = (char *) (p + size) ;
+    objects ++ ;
+    used += size ;
+    return (void *) p ;
+}
+
+void Arena::atRelease (void *object, void (*destroy) (void *)) {
+    Finalizer *f = (Finalizer *) allocate (sizeof (Finalizer), alignof (Finalizer)) ;
+    objects -- ;
+    f->next = finalizers ;
+    f->destroy = destroy ;
+    f->object = object ;
+    finalizers = f ;
+}
+
+void Arena::release () {
+    // Newest first, so an object may refer to older ones as it dies.
+    while (finalizers != NULL) {
+        Finalizer *f = finalizers ;
+        finalizers = f->next ;
+        f->destroy (f->object) ;
+    }
+    current = NULL ;
+    next = end = NULL ;
+    objects = 0 ;
+    used = 0 ;
+}
@@ -0,0 +1,83 @@
+/* arena.h
+
+   This file declares the [Arena] class, a bump-pointer allocator for
+   objects that all live exactly as long as one translation, such as
+   the nodes of an AST.
+
+   Objects are carved out of large blocks, so making one costs a few
+   instructions and no call to malloc.  Nothing is freed one object at
+   a time: [release], or destroying the Arena, runs the destructors of
+   every object made with [make], newest first, and gives back the
+   memory in one step.  The blocks are kept for reuse, so an Arena that
+   is released after each translation settles at the size the largest
+   one needed.
+ */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+class Arena {
+public:
+    Arena (size_t blockSize = 64 * 1024) ;
+    ~Arena () ;
+
+    // Returns [size] bytes aligned to [align], a power of two.
+    void *allocate (size_t size, size_t align) ;
+
+    // Constructs a T in the arena.  Its destructor is run by release.
+    template <typename T, typename... Args>
+    T *make (Args&&... args) {
+        void *p = allocate (sizeof (T), alignof (T)) ;
+        T *t = new (p) T (std::forward<Args>(args)...) ;
+        if (! std::is_trivially_destructible<T>::value)
+            atRelease (t, destroy<T>) ;
+        return t ;
+    }
+
+    // Destroys every object; the blocks are kept for the next ones.
+    void release () ;
+
+    // Objects and bytes since the last release, and blocks held.
+    size_t numObjects () const { return objects ; }
+    size_t bytesUsed () const { return used ; }
+    size_t numBlocks () const { return blocks ; }
+
+private:
+    Arena (const Arena &) ;
+    Arena &operator= (const Arena &) ;
+
+    struct Block {
+        Block *next ;
+        size_t size ;
+    } ;
+
+    // Destructors to run, kept in the arena itself as a stack.
+    struct Finalizer {
+        Finalizer *next ;
+        void (*destroy) (void *) ;
+        void *object ;
+    } ;
+
+    template <typename T>
+    static void destroy (void *p) { static_cast<T *>(p)->~T() ; }
+
+    void atRelease (void *object, void (*destroy) (void *)) ;
+    void nextBlock (size_t minSize) ;
+
+    size_t blockSize ;
+    Block *first ;
+    Block *current ;      // blocks after this one are unused
+    char *next ;          // the free part of [current]
+    char *end ;
+    Finalizer *finalizers ;
+
+    size_t objects ;
+    size_t used ;
+    size_t blocks ;
+} ;
+
+#endif /* ARENA_H */
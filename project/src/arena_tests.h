@@ -0,0 +1,98 @@
+#include <cxxtest/TestSuite.h>
+#include "arena.h"
+
+#include <string>
+#include <stdint.h>
+
+using namespace std ;
+
+// Counts its live instances, to check that release runs destructors.
+class Counted {
+public:
+    Counted (int *live, int v) : live(live), value(v) { (*live) ++ ; }
+    ~Counted () { (*live) -- ; }
+    int *live ;
+    int value ;
+} ;
+
+class ArenaTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    // Tests for Arena
+    // --------------------------------------------------
+
+    void test_allocate_aligned ( void ) {
+        Arena arena (256) ;
+        for (int i = 0; i < 100; i ++) {
+            char *c = (char *) arena.allocate (1, 1) ;
+            double *d = (double *) arena.allocate (sizeof (double), alignof (double)) ;
+            TS_ASSERT (c != NULL) ;
+            TS_ASSERT_EQUALS ((uintptr_t) d % alignof (double), 0u) ;
+        }
+        TS_ASSERT_EQUALS (arena.numObjects (), 200u) ;
+        TS_ASSERT (arena.numBlocks () > 1) ;
+    }
+
+    void test_make_and_release ( void ) {
+        int live = 0 ;
+        Arena arena (256) ;
+        Counted *first = arena.make<Counted> (&live, 1) ;
+        for (int i = 2; i <= 100; i ++)
+            arena.make<Counted> (&live, i) ;
+        string *s = arena.make<string> ("a string longer than any small string buffer") ;
+        TS_ASSERT_EQUALS (live, 100) ;
+        TS_ASSERT_EQUALS (first->value, 1) ;
+        TS_ASSERT_EQUALS (s->size (), 44u) ;
+        TS_ASSERT_EQUALS (arena.numObjects (), 101u) ;
+
+        size_t blocks = arena.numBlocks () ;
+        arena.release () ;
+        TS_ASSERT_EQUALS (live, 0) ;
+        TS_ASSERT_EQUALS (arena.numObjects (), 0u) ;
+        TS_ASSERT_EQUALS (arena.numBlocks (), blocks) ;
+
+        // The same objects again fit in the blocks already held.
+        for (int i = 1; i <= 100; i ++)
+            arena.make<Counted> (&live, i) ;
+        TS_ASSERT_EQUALS (live, 100) ;
+        TS_ASSERT_EQUALS (arena.numBlocks (), blocks) ;
+    }
+
+    // An object larger than a block gets a block of its own.
+    void test_large_object ( void ) {
+        Arena arena (256) ;
+        char *big = (char *) arena.allocate (10000, 16) ;
+        big[0] = big[9999] = 'x' ;
+        TS_ASSERT_EQUALS ((uintptr_t) big % 16, 0u) ;
+        char *small = (char *) arena.allocate (8, 8) ;
+        TS_ASSERT (small != NULL) ;
+
+        // A kept block too small for the first object is passed over.
+        arena.release () ;
+        big = (char *) arena.allocate (20000, 16) ;
+        big[0] = big[19999] = 'x' ;
+        TS_ASSERT_EQUALS (arena.numBlocks (), 2u) ;
+    }
+
+    // The destructor runs what release would.
+    void test_destroy ( void ) {
+        int live = 0 ;
+        {
+            Arena arena ;
+            for (int i = 0; i < 10; i ++)
+                arena.make<Counted> (&live, i) ;
+            TS_ASSERT_EQUALS (live, 10) ;
+        }
+        TS_ASSERT_EQUALS (live, 0) ;
+    }
+
+    // After a release the same memory is used again.
+    void test_reuse ( void ) {
+        Arena arena ;
+        void *p = arena.allocate (64, 8) ;
+        arena.release () ;
+        TS_ASSERT_EQUALS (arena.allocate (64, 8), p) ;
+    }
+
+} ;
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <fstream>
+#include <sstream>
 
 using namespace std ;
 
@@ -79,7 +80,7 @@ public:
 
     /*! \brief Ensures the root of the function can be parsed
 
-        Tests that Root and EmptyStmts are correctly integrated
+        Tests that Root and an empty StmtList are correctly integrated
         into the parser
 
         This was the first test to pass on 11/18/2014
@@ -127,8 +128,48 @@ public:
     void test_sample_5 ( void ) { unparse_tests ( "sample_5.dsl" ); }
     void test_mysample ( void ) { unparse_tests ( "mysample.dsl" ); }
     void test_forest_loss ( void ) { unparse_tests ( "forest_loss_v2.dsl" ); }
-} ;
-
-
 
+    // Node kinds and the typed accessors that replace dynamic_cast.
+    void test_node_kinds ( void ) {
+        VarName v ("x") ;
+        AnyConst c ("1") ;
+        BinOpExpr b (&v, "+", &c) ;
+        PrintStmt ps (&b) ;
+        StmtList sl ;
+        TS_ASSERT_EQUALS ( v.kind(), varNameNode ) ;
+        TS_ASSERT_EQUALS ( b.kind(), binOpExprNode ) ;
+        TS_ASSERT ( v.isExpr() && b.isExpr() && ! ps.isExpr() ) ;
+        TS_ASSERT ( ps.isStmt() && ! sl.isStmt() && sl.isStmts() ) ;
+        TS_ASSERT_EQUALS ( v.asVarName(), &v ) ;
+        TS_ASSERT ( b.asVarName() == NULL && b.asStmt() == NULL ) ;
+        TS_ASSERT_EQUALS ( b.asExpr(), &b ) ;
+        TS_ASSERT_EQUALS ( ps.asStmt(), &ps ) ;
+        TS_ASSERT_EQUALS ( sl.asStmts(), &sl ) ;
+
+        pr = p.parse ( "main () { x = 1 ; }" ) ;
+        TS_ASSERT ( pr.ok ) ;
+        TS_ASSERT_EQUALS ( pr.ast->kind(), rootNode ) ;
+        TS_ASSERT ( pr.expr() == NULL && pr.stmt() == NULL && pr.stmts() == NULL ) ;
+    }
 
+    // An Emitter on a stream writes the same text as cppCode, in
+    // pieces no larger than its buffer.
+    void test_emit_to_stream ( void ) {
+        string text = "main () { Int x ; " ;
+        for (int i = 0; i < 20000; i ++)
+            text += "x = (x + 1) * 2 ; " ;
+        text += "}" ;
+        pr = p.parse ( text.c_str() ) ;
+        TS_ASSERT ( pr.ok ) ;
+        string code = pr.ast->cppCode() ;
+        TS_ASSERT ( code.size() > 2 * Emitter::flushSize ) ;
+
+        ostringstream stream ;
+        {
+            Emitter out (stream) ;
+            pr.ast->emitCppCode (out) ;
+            TS_ASSERT ( out.str().size() < Emitter::flushSize ) ;
+        }
+        TS_ASSERT_EQUALS ( stream.str(), code ) ;
+    }
+} ;
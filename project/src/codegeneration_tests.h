@@ -1,6 +1,9 @@
 #include <cxxtest/TestSuite.h>
 #include <iostream> 
 #include "parser.h"
+#include "symbolTable.h"
+#include "typeChecker.h"
+#include "constantFolder.h"
 #include "readInput.h"
 
 #include <stdlib.h>
@@ -34,7 +37,11 @@ public:
         return readInput (2, makeArgs("translator", fn) ) ;
     }
 
-    void codegen_tests ( string filebase, bool checkExpected ) {
+    /* With [runPasses] set, the NameResolver, TypeChecker and
+       ConstantFolder run over the tree before its C++ code is written,
+       which must still give the expected output.
+     */
+    void codegen_tests ( string filebase, bool checkExpected, bool runPasses = false ) {
         string file = filebase + ".dsl" ;
         string path = "../samples/" + file ; 
         string cppbase =  "../samples/" + filebase ;
@@ -55,6 +62,21 @@ public:
         // 2. Verify that the ast field is not null
         TSM_ASSERT ( file + " failed to generate an AST.", pr1.ast != NULL );
 
+        // 2a. Resolve names and types, so the C++ code is typed, and
+        // fold constants.
+        if ( runPasses ) {
+            SymbolTable table ;
+            NameResolver names ( table ) ;
+            TypeChecker types ( table ) ;
+            ConstantFolder folder ( table, p.arena ) ;
+            PassManager passes ;
+            passes.add ( &names ) ;
+            passes.add ( &types ) ;
+            passes.add ( &folder ) ;
+            passes.run ( pr1.ast->asRoot() ) ;
+            TSM_ASSERT ( file + " has type errors.", types.diagnostics.empty() ) ;
+        }
+
         // 3. Verify that the C++ code is non-empty.
         string cpp1 = pr1.ast->cppCode() ;
         TSM_ASSERT ( file + " failed to generate non-empty C++ code.", 
@@ -100,6 +122,16 @@ public:
     void test_my_code_2 ( void ) { codegen_tests ( "my_code_2", true ) ; }
 
     void test_forest_loss ( void ) { codegen_tests ( "forest_loss_v2", true ); }
+
+    // The same programs, after the passes that come before codegen.
+    void test_passes_sample_4 ( void ) { codegen_tests ( "sample_4", true, true ); }
+    void test_passes_sample_5 ( void ) { codegen_tests ( "sample_5", true, true ); }
+    void test_passes_sample_6 ( void ) { codegen_tests ( "sample_6", true, true ); }
+    void test_passes_sample_7 ( void ) { codegen_tests ( "sample_7", true, true ); }
+    void test_passes_sample_8 ( void ) { codegen_tests ( "sample_8", true, true ); }
+    void test_passes_my_code_1 ( void ) { codegen_tests ( "my_code_1", true, true ) ; }
+    void test_passes_my_code_2 ( void ) { codegen_tests ( "my_code_2", true, true ) ; }
+    void test_passes_forest_loss ( void ) { codegen_tests ( "forest_loss_v2", true, true ); }
 } ;
 
 
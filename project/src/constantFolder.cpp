@@ -0,0 +1,282 @@
+/* constantFolder.cpp
+
+   This file provides the [ConstantFolder] pass.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "constantFolder.h"
+
+using namespace std ;
+
+/* Counts the assignments to each Symbol, and finds the list of
+   statements each scalar is declared in and assigned in.  A for loop
+   assigns to its variable.
+ */
+class Assignments : public ConstASTVisitor {
+public:
+	Assignments (size_t n) : count(n, 0), declaredIn(n, NULL), assignedIn(n, NULL) { }
+
+	vector<int> count ;
+	vector<const StmtList *> declaredIn ;
+	vector<const StmtList *> assignedIn ;
+
+	void visitStmtList (const StmtList *n) {
+		for (size_t i = 0; i < n->stmts.size(); i++) {
+			const Stmt *s = n->stmts[i] ;
+			if (s->kind() == standardDeclNode)
+				note (declaredIn, static_cast<const StandardDecl *>(s)->varName, n) ;
+			else if (s->kind() == standardAssignStmtNode)
+				note (assignedIn, static_cast<const StandardAssignStmt *>(s)->varName, n) ;
+			visit (s) ;
+		}
+	}
+	void visitStandardAssignStmt (const StandardAssignStmt *n) {
+		assigned (n->varName) ;
+		visitChildren (n) ;
+	}
+	void visitForStmt (const ForStmt *n) {
+		assigned (n->varName) ;
+		visitChildren (n) ;
+	}
+
+private:
+	void note (vector<const StmtList *> &where, const VarName *v, const StmtList *l) {
+		if (v->symbol < where.size())
+			where[v->symbol] = l ;
+	}
+	void assigned (const VarName *v) {
+		if (v->symbol < count.size())
+			count[v->symbol] ++ ;
+	}
+} ;
+
+// The shortest text that reads back as [f], or "" if it needs an
+// exponent, which a literal cannot have.
+static string floatText (float f) {
+	char text[32] ;
+	for (int digits = 1; digits <= 9; digits++) {
+		snprintf (text, sizeof text, "%.*g", digits, f) ;
+		if (strtof (text, NULL) == f)
+			break ;
+	}
+	string s = text ;
+	if (s.find ('e') != string::npos)
+		return "" ;
+	if (s.find ('.') == string::npos)
+		s += ".0" ;
+	return s ;
+}
+
+static bool isLiteral (const Expr *e, exprType t) {
+	return e->kind() == anyConstNode && e->type() == t ;
+}
+
+static bool isLiteralValue (const Expr *e, double v) {
+	if (isLiteral (e, intType) || isLiteral (e, floatType))
+		return strtod (static_cast<const AnyConst *>(e)->constString.c_str(), NULL) == v ;
+	return false ;
+}
+
+// A node whose C++ code needs no parentheses to be an operand.
+static bool isAtom (const Expr *e) {
+	switch (e->kind()) {
+	case varNameNode: case anyConstNode: case parensExprNode:
+	case matrixRefExprNode: case functionCallNode:
+		return true ;
+	default:
+		return false ;
+	}
+}
+
+void ConstantFolder::run (Root *root) {
+	Assignments a (table.size()) ;
+	a.visit (root) ;
+	once.assign (table.size(), false) ;
+	values.assign (table.size(), NULL) ;
+	for (SymbolId i = 0; i < table.size(); i++) {
+		const Symbol &s = table.symbol (i) ;
+		once[i] = s.kind == scalarSymbol && ! s.loopVariable && a.count[i] == 1 &&
+		          a.assignedIn[i] != NULL && a.assignedIn[i] == a.declaredIn[i] ;
+	}
+	changes = 0 ;
+	visit (root) ;
+}
+
+AnyConst *ConstantFolder::literal (const string &text, exprType type) {
+	AnyConst *c = arena.make<AnyConst> (text) ;
+	c->setType (type) ;
+	changes ++ ;
+	return c ;
+}
+
+// The target is not visited: it is assigned to, not used.
+Node *ConstantFolder::visitStandardAssignStmt (StandardAssignStmt *n) {
+	n->expr = visitExpr (n->expr) ;
+	SymbolId s = n->varName->symbol ;
+	if (s < once.size() && once[s] && n->varName->type() != unknownType &&
+	    isLiteral (n->expr, n->varName->type()))
+		values[s] = static_cast<AnyConst *>(n->expr) ;
+	return n ;
+}
+
+Node *ConstantFolder::visitVarUse (VarName *n) {
+	if (n->symbol < values.size() && values[n->symbol] != NULL)
+		return literal (values[n->symbol]->constString, values[n->symbol]->type()) ;
+	return n ;
+}
+
+// The literal for [l] op [r], or NULL if it cannot be computed as the
+// C++ code would compute it.
+AnyConst *ConstantFolder::fold (BinOpExpr *n, AnyConst *l, AnyConst *r) {
+	if (l->type() != r->type())
+		return NULL ;
+	const char *bools[] = { "False", "True" } ;
+
+	if (l->type() == boolType) {
+		bool a = l->constString == "True", b = r->constString == "True" ;
+		if (n->op == "&&") return literal (bools[a && b], boolType) ;
+		if (n->op == "||") return literal (bools[a || b], boolType) ;
+		if (n->op == "==") return literal (bools[a == b], boolType) ;
+		if (n->op == "!=") return literal (bools[a != b], boolType) ;
+		return NULL ;
+	}
+
+	binaryOp op = binaryOpNamed (n->op) ;
+	if (l->type() == intType) {
+		long long a = strtoll (l->constString.c_str(), NULL, 10) ;
+		long long b = strtoll (r->constString.c_str(), NULL, 10) ;
+		long long v ;
+		switch (op) {
+		case addOp: v = a + b ; break ;
+		case subOp: v = a - b ; break ;
+		case mulOp: v = a * b ; break ;
+		case divOp:
+			if (b == 0)
+				return NULL ;
+			v = a / b ;
+			break ;
+		case lessOp: return literal (bools[a < b], boolType) ;
+		case lessEqualOp: return literal (bools[a <= b], boolType) ;
+		case greaterOp: return literal (bools[a > b], boolType) ;
+		case greaterEqualOp: return literal (bools[a >= b], boolType) ;
+		case equalOp: return literal (bools[a == b], boolType) ;
+		case notEqualOp: return literal (bools[a != b], boolType) ;
+		default: return NULL ;
+		}
+		if (v < INT_MIN || v > INT_MAX)
+			return NULL ;
+		return literal (to_string (v), intType) ;
+	}
+
+	if (l->type() == floatType) {
+		float a = strtof (l->constString.c_str(), NULL) ;
+		float b = strtof (r->constString.c_str(), NULL) ;
+		float v ;
+		switch (op) {
+		case addOp: v = a + b ; break ;
+		case subOp: v = a - b ; break ;
+		case mulOp: v = a * b ; break ;
+		case divOp: v = a / b ; break ;
+		case lessOp: return literal (bools[a < b], boolType) ;
+		case lessEqualOp: return literal (bools[a <= b], boolType) ;
+		case greaterOp: return literal (bools[a > b], boolType) ;
+		case greaterEqualOp: return literal (bools[a >= b], boolType) ;
+		case equalOp: return literal (bools[a == b], boolType) ;
+		case notEqualOp: return literal (bools[a != b], boolType) ;
+		default: return NULL ;
+		}
+		string text = isfinite (v) ? floatText (v) : "" ;
+		if (text.empty())
+			return NULL ;
+		return literal (text, floatType) ;
+	}
+	return NULL ;
+}
+
+// The operand [n] equals, if it is an identity that holds for every
+// value of that operand, or NULL.  x + 0 is not x for a Float x of
+// -0.0, so only Ints are simplified that way.
+Expr *ConstantFolder::simplify (BinOpExpr *n) {
+	Expr *x = NULL ;
+	switch (binaryOpNamed (n->op)) {
+	case addOp:
+		if (n->type() != intType)
+			return NULL ;
+		if (isLiteralValue (n->right, 0)) x = n->left ;
+		else if (isLiteralValue (n->left, 0)) x = n->right ;
+		break ;
+	case subOp:
+		if (isLiteralValue (n->right, 0)) x = n->left ;
+		break ;
+	case mulOp:
+		if (isLiteralValue (n->right, 1)) x = n->left ;
+		else if (isLiteralValue (n->left, 1)) x = n->right ;
+		break ;
+	case divOp:
+		if (isLiteralValue (n->right, 1)) x = n->left ;
+		break ;
+	default:
+		break ;
+	}
+	// i * 1.0 is a Float, not the Int i.
+	if (x == NULL || x->type() != n->type() || n->type() == unknownType)
+		return NULL ;
+	return x ;
+}
+
+Node *ConstantFolder::visitBinOpExpr (BinOpExpr *n) {
+	visitChildren (n) ;
+	// A literal put in for an Int variable may now meet a Float; it is
+	// made one, as the TypeChecker does.
+	if (n->left->type() == floatType && isLiteral (n->right, intType))
+		n->right->setType (floatType) ;
+	if (n->right->type() == floatType && isLiteral (n->left, intType))
+		n->left->setType (floatType) ;
+	if (n->left->kind() == anyConstNode && n->right->kind() == anyConstNode) {
+		AnyConst *c = fold (n, static_cast<AnyConst *>(n->left), static_cast<AnyConst *>(n->right)) ;
+		if (c != NULL)
+			return c ;
+	}
+	Expr *x = simplify (n) ;
+	if (x != NULL) {
+		changes ++ ;
+		return x ;
+	}
+	return n ;
+}
+
+Node *ConstantFolder::visitParensExpr (ParensExpr *n) {
+	visitChildren (n) ;
+	if (n->expr->kind() == varNameNode || n->expr->kind() == anyConstNode) {
+		changes ++ ;
+		return n->expr ;
+	}
+	return n ;
+}
+
+Node *ConstantFolder::visitNotExpr (NotExpr *n) {
+	visitChildren (n) ;
+	if (isLiteral (n->expr, boolType)) {
+		bool b = static_cast<AnyConst *>(n->expr)->constString == "True" ;
+		return literal (b ? "False" : "True", boolType) ;
+	}
+
+	Expr *inner = n->expr ;
+	while (inner->kind() == parensExprNode)
+		inner = static_cast<ParensExpr *>(inner)->expr ;
+	if (inner->kind() != notExprNode)
+		return n ;
+	Expr *x = static_cast<NotExpr *>(inner)->expr ;
+	if (x->type() != boolType)
+		return n ;
+	changes ++ ;
+	if (isAtom (x))
+		return x ;
+	ParensExpr *p = arena.make<ParensExpr> (x) ;
+	p->setType (boolType) ;
+	return p ;
+}
@@ -0,0 +1,64 @@
+/* constantFolder.h
+
+   This file declares [ConstantFolder], the pass that simplifies the
+   expressions of a tree before its C++ code is written.  It runs after
+   a NameResolver and a TypeChecker, and uses the types they find to
+   compute as the C++ code would: Ints as int, Floats as float.
+
+   It makes four kinds of change:
+     - an operator or ! applied to literals becomes the literal for its
+       value, unless that is a division by zero, an int overflow, or a
+       float that is not finite;
+     - a scalar variable that is assigned just once, to a literal, in
+       the list of statements it is declared in, is replaced by the
+       literal wherever it is used after that assignment;
+     - x * 1, x / 1 and x - 0, and x + 0 and 0 + x for Ints, become x,
+       and !!x becomes x for a Bool x;
+     - parentheses around a single name or literal are dropped.
+
+   So, for example, "for (k = 0 : season_length - 1)", after
+   "season_length = 7 ;", becomes "for (k = 0 : 6)".
+
+   New nodes are made in [arena], the Arena the tree is in.
+ */
+#ifndef CONSTANTFOLDER_H
+#define CONSTANTFOLDER_H
+
+#include <vector>
+
+#include "AST.h"
+#include "arena.h"
+#include "symbolTable.h"
+#include "visitor.h"
+
+class ConstantFolder : public ASTVisitor, public Pass {
+public:
+	ConstantFolder (const SymbolTable &t, Arena &a) : changes(0), table(t), arena(a) { }
+
+	const char *name () const { return "fold-constants" ; }
+	void run (Root *root) ;
+
+	Node *visitStandardAssignStmt (StandardAssignStmt *n) ;
+	Node *visitVarUse (VarName *n) ;
+	Node *visitBinOpExpr (BinOpExpr *n) ;
+	Node *visitParensExpr (ParensExpr *n) ;
+	Node *visitNotExpr (NotExpr *n) ;
+
+	// The number of nodes replaced in the last run.
+	int changes ;
+
+private:
+	AnyConst *literal (const std::string &text, exprType type) ;
+	AnyConst *fold (BinOpExpr *n, AnyConst *l, AnyConst *r) ;
+	Expr *simplify (BinOpExpr *n) ;
+
+	const SymbolTable &table ;
+	Arena &arena ;
+	// For each Symbol: whether it is a scalar assigned just once, in
+	// the statements it is declared in, and the literal assigned to it
+	// once that assignment has been passed.
+	std::vector<bool> once ;
+	std::vector<AnyConst *> values ;
+} ;
+
+#endif /* CONSTANTFOLDER_H */
@@ -0,0 +1,138 @@
+#include <cxxtest/TestSuite.h>
+#include "parser.h"
+#include "typeChecker.h"
+#include "constantFolder.h"
+#include "readInput.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std ;
+
+class ConstantFolderTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    Parser p ;
+    ParseResult pr ;
+    SymbolTable table ;
+    int changes ;
+
+    char **makeArgs ( const char *a0, const char *a1) {
+        char **aa = (char **) malloc (sizeof(char *) * 2) ;
+        aa[0] = (char *) malloc ( sizeof(char) * (strlen(a0) + 1) ) ;
+        strcpy (aa[0], a0 ) ;
+        aa[1] = (char *) malloc ( sizeof(char) * (strlen(a1) + 1) ) ;
+        strcpy (aa[1], a1 ) ;
+        return aa ;
+    }
+
+    // The C++ code of [text] after the passes that come before codegen.
+    string optimize ( const char *text ) {
+        pr = p.parse ( text ) ;
+        TS_ASSERT ( pr.ok ) ;
+        NameResolver names ( table ) ;
+        TypeChecker types ( table ) ;
+        ConstantFolder folder ( table, p.arena ) ;
+        PassManager passes ;
+        passes.add ( &names ) ;
+        passes.add ( &types ) ;
+        passes.add ( &folder ) ;
+        passes.run ( pr.ast->asRoot() ) ;
+        TS_ASSERT ( types.diagnostics.empty () ) ;
+        changes = folder.changes ;
+        return pr.ast->cppCode () ;
+    }
+
+    bool has ( const string &code, const char *s ) {
+        return code.find ( s ) != string::npos ;
+    }
+
+    void test_fold ( void ) {
+        string code = optimize ( "main () { Int i ; Float f ; Bool b ; "
+                                 "i = 2 + 3 * 4 ; f = 0.0 - 25 ; i = 7 / 2 ; "
+                                 "i = (1 - 8) / 2 ; i = 1 / 0 ; f = 1.0 / 4 ; "
+                                 "b = 3 < 2 ; b = ! (1 == 2) ; i = 2147483647 + 1 ; }" ) ;
+        TS_ASSERT ( has ( code, "i = 14;\n" ) ) ;
+        TS_ASSERT ( has ( code, "f = -25.0f;\n" ) ) ;
+        TS_ASSERT ( has ( code, "i = 3;\n" ) ) ;
+        TS_ASSERT ( has ( code, "i = -3;\n" ) ) ;
+        TS_ASSERT ( has ( code, "i = 1 / 0;\n" ) ) ;
+        TS_ASSERT ( has ( code, "f = 0.25f;\n" ) ) ;
+        TS_ASSERT ( has ( code, "b = false;\n" ) ) ;
+        TS_ASSERT ( has ( code, "b = true;\n" ) ) ;
+        TS_ASSERT ( has ( code, "i = 2147483647 + 1;\n" ) ) ;
+    }
+
+    // A variable assigned a literal once, where it is declared, is
+    // that literal from there on; so loop bounds become literals.
+    void test_propagate ( void ) {
+        string code = optimize ( "main () { Int n ; Int m ; Int k ; Int t ; "
+                                 "print ( m ) ; n = 7 ; m = 3 ; "
+                                 "for ( k = 0 : n - 1 ) { t = k * m ; } "
+                                 "print ( m + 0 ) ; "
+                                 "Int w ; w = 1 ; w = 2 ; print ( w ) ; "
+                                 "Int v ; { v = 4 ; } print ( v ) ; }" ) ;
+        TS_ASSERT ( has ( code, "cout << m;\n" ) ) ;
+        TS_ASSERT ( has ( code, "for(k=0; k <= 6; k ++)" ) ) ;
+        TS_ASSERT ( has ( code, "t = k * 3;\n" ) ) ;
+        TS_ASSERT ( has ( code, "cout << 3;\n" ) ) ;
+        TS_ASSERT ( has ( code, "cout << w;\n" ) ) ;
+        TS_ASSERT ( has ( code, "cout << v;\n" ) ) ;
+    }
+
+    void test_identities ( void ) {
+        string code = optimize ( "main () { Int i ; Float f ; Bool b ; "
+                                 "i = i * 1 + 0 ; f = (f - 0) / 1 ; f = f + 0 ; "
+                                 "f = i * 1.0 ; b = ! ( ! b ) ; "
+                                 "b = ! ! i < 3 ; b = ! ! i ; }" ) ;
+        TS_ASSERT ( has ( code, "i = i;\n" ) ) ;
+        TS_ASSERT ( has ( code, "f = f;\n" ) ) ;
+        TS_ASSERT ( has ( code, "f = f + 0.0f;\n" ) ) ;
+        TS_ASSERT ( has ( code, "f = i * 1.0f;\n" ) ) ;
+        TS_ASSERT ( has ( code, "b = b;\n" ) ) ;
+        // ! applies to all of i < 3, so what is left keeps parentheses.
+        TS_ASSERT ( has ( code, "b = (i < 3);\n" ) ) ;
+        TS_ASSERT ( has ( code, "b = !!i;\n" ) ) ;
+    }
+
+    // Nothing to fold leaves the tree as it was.
+    void test_no_change ( void ) {
+        string before = p.parse ( "main () { Int i ; i = i + 1 ; print ( i * 2 ) ; }" ).ast->cppCode () ;
+        string after = optimize ( "main () { Int i ; i = i + 1 ; print ( i * 2 ) ; }" ) ;
+        TS_ASSERT_EQUALS ( changes, 0 ) ;
+        TS_ASSERT_EQUALS ( before, after ) ;
+    }
+
+    /* A chain of operators is walked with loops by the parser, the
+       visitors and the emitters, so each pass handles a long one; here
+       a million operands, which all fold to one literal, or to x.
+     */
+    string chain ( const char *first, const char *next ) {
+        string text = string ( "main () { Int x ; x = " ) + first ;
+        for (int i = 1; i < 1000000; i ++)
+            text += next ;
+        return text + " ; }" ;
+    }
+
+    void test_long_chain ( void ) {
+        string code = optimize ( chain ( "1", " + 2" ).c_str() ) ;
+        TS_ASSERT_EQUALS ( changes, 999999 ) ;
+        TS_ASSERT ( has ( code, "x = 1999999;\n" ) ) ;
+        code = optimize ( chain ( "x", " + 0" ).c_str() ) ;
+        TS_ASSERT ( has ( code, "x = x;\n" ) ) ;
+        code = optimize ( chain ( "1", " + x" ).c_str() ) ;
+        TS_ASSERT_EQUALS ( changes, 0 ) ;
+        TS_ASSERT ( has ( code, "x = 1 + x + x + x" ) ) ;
+    }
+
+    void test_forest_loss ( void ) {
+        string code = optimize ( readInput (2, makeArgs("translator", "../samples/forest_loss_v2.dsl")) ) ;
+        TS_ASSERT ( changes > 0 ) ;
+        TS_ASSERT ( has ( code, "ceil(cols * 1.0f / 7.0f)" ) ) ;
+        TS_ASSERT ( has ( code, "k = i * 7 + j;\n" ) ) ;
+        TS_ASSERT ( has ( code, "for(k=0; k <= 6; k ++)" ) ) ;
+        TS_ASSERT ( has ( code, "maximum = -25.0f;\n" ) ) ;
+        TS_ASSERT ( ! has ( code, "season_length-" ) ) ;
+    }
+} ;
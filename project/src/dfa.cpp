@@ -0,0 +1,316 @@
+/* dfa.cpp
+
+   This file provides the [makeDFA] and [matchDFA] functions.
+
+   Patterns are first translated into a nondeterministic automaton
+   (Thompson's construction) and then into a DFA by the subset
+   construction.  The pattern syntax is the subset of POSIX extended
+   regular expressions used by the scanner: literals, '\' escapes,
+   '.', bracket expressions with ranges and '^' negation, grouping,
+   '|', '*', '+' and '?'.  As with regcomp, a '\' inside a bracket
+   expression is an ordinary character.
+
+   Every pattern is matched at the start of the text, whether or not
+   it begins with '^'.  The scanner only asks for matches at the start
+   of a token, so this agrees with what regexec reports there.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <string.h>
+
+#include "dfa.h"
+
+using namespace std ;
+
+typedef bitset<256> charSet ;
+
+/* One state of the nondeterministic automaton.  A state has at most
+   one character edge (to [next], on any byte in [chars]) and any
+   number of epsilon edges.
+ */
+class NFAState {
+public:
+    NFAState () : next(-1), pattern(-1) { }
+    vector<int> epsilon ;
+    charSet chars ;
+    int next ;
+    int pattern ;
+} ;
+
+// A piece of automaton with a single entry and a single exit state.
+class Fragment {
+public:
+    Fragment (int s, int e) : start(s), end(e) { }
+    int start ;
+    int end ;
+} ;
+
+class NFABuilder {
+public:
+    NFABuilder (const char *p) : pos(p), depth(0), ok(true) { }
+
+    vector<NFAState> *states ;
+    const char *pos ;
+    int depth ;
+    bool ok ;
+
+    int newState () {
+        states->push_back (NFAState()) ;
+        return states->size() - 1 ;
+    }
+
+    Fragment charFragment (const charSet &cs) {
+        int s = newState() ;
+        int e = newState() ;
+        (*states)[s].chars = cs ;
+        (*states)[s].next = e ;
+        return Fragment(s, e) ;
+    }
+
+    // Alt ::= Concat ( '|' Concat )*
+    Fragment parseAlt () {
+        Fragment left = parseConcat() ;
+        while (ok && *pos == '|') {
+            pos ++ ;
+            Fragment right = parseConcat() ;
+            int s = newState() ;
+            int e = newState() ;
+            (*states)[s].epsilon.push_back (left.start) ;
+            (*states)[s].epsilon.push_back (right.start) ;
+            (*states)[left.end].epsilon.push_back (e) ;
+            (*states)[right.end].epsilon.push_back (e) ;
+            left = Fragment(s, e) ;
+        }
+        return left ;
+    }
+
+    // Concat ::= Repeat*   (a ')' outside any group is an ordinary character)
+    Fragment parseConcat () {
+        int s = newState() ;
+        Fragment whole(s, s) ;
+        while (ok && *pos != '\0' && *pos != '|' && ! (*pos == ')' && depth > 0)) {
+            Fragment next = parseRepeat() ;
+            (*states)[whole.end].epsilon.push_back (next.start) ;
+            whole.end = next.end ;
+        }
+        return whole ;
+    }
+
+    // Repeat ::= Atom ( '*' | '+' | '?' )*
+    Fragment parseRepeat () {
+        Fragment f = parseAtom() ;
+        while (ok && (*pos == '*' || *pos == '+' || *pos == '?')) {
+            int s = newState() ;
+            int e = newState() ;
+            (*states)[s].epsilon.push_back (f.start) ;
+            (*states)[f.end].epsilon.push_back (e) ;
+            if (*pos != '+')
+                (*states)[s].epsilon.push_back (e) ;
+            if (*pos != '?')
+                (*states)[f.end].epsilon.push_back (f.start) ;
+            f = Fragment(s, e) ;
+            pos ++ ;
+        }
+        return f ;
+    }
+
+    Fragment parseAtom () {
+        charSet cs ;
+        char c = *pos ++ ;
+        switch (c) {
+        case '(': {
+            depth ++ ;
+            Fragment f = parseAlt() ;
+            depth -- ;
+            if (*pos != ')')
+                ok = false ;
+            else
+                pos ++ ;
+            return f ;
+        }
+        case '[':
+            return charFragment (parseBracket()) ;
+        case '.':
+            cs.set() ;
+            cs.reset(0) ;
+            return charFragment (cs) ;
+        case '\\':
+            if (*pos == '\0') {
+                ok = false ;
+                return charFragment (cs) ;
+            }
+            cs.set ((unsigned char) *pos ++) ;
+            return charFragment (cs) ;
+        default:
+            cs.set ((unsigned char) c) ;
+            return charFragment (cs) ;
+        }
+    }
+
+    // The opening '[' has been consumed.
+    charSet parseBracket () {
+        charSet cs ;
+        bool negate = false ;
+        if (*pos == '^') {
+            negate = true ;
+            pos ++ ;
+        }
+        // A ']' right after the '[' or '[^' is an ordinary character.
+        bool first = true ;
+        while (*pos != '\0' && (first || *pos != ']')) {
+            unsigned char lo = *pos ++ ;
+            unsigned char hi = lo ;
+            if (pos[0] == '-' && pos[1] != ']' && pos[1] != '\0') {
+                hi = pos[1] ;
+                pos += 2 ;
+            }
+            for (int ch = lo; ch <= hi; ch ++)
+                cs.set (ch) ;
+            first = false ;
+        }
+        if (*pos != ']')
+            ok = false ;
+        else
+            pos ++ ;
+        if (negate)
+            cs.flip() ;
+        cs.reset(0) ;
+        return cs ;
+    }
+} ;
+
+// Adds to [set] every state reachable from it by epsilon edges.
+static void closure (const vector<NFAState> &states, vector<int> &set) {
+    vector<bool> seen (states.size(), false) ;
+    vector<int> work (set) ;
+    set.clear() ;
+    while (! work.empty()) {
+        int s = work.back() ;
+        work.pop_back() ;
+        if (seen[s])
+            continue ;
+        seen[s] = true ;
+        set.push_back (s) ;
+        for (size_t i = 0; i < states[s].epsilon.size(); i ++)
+            work.push_back (states[s].epsilon[i]) ;
+    }
+    sort (set.begin(), set.end()) ;
+}
+
+DFA *makeDFA (const char **patterns, int numPatterns) {
+    vector<NFAState> states (1) ;
+    int start = 0 ;
+
+    for (int i = 0; i < numPatterns; i ++) {
+        NFABuilder b(patterns[i]) ;
+        b.states = &states ;
+        if (*b.pos == '^')
+            b.pos ++ ;
+        Fragment f = b.parseAlt() ;
+        if (! b.ok || *b.pos != '\0')
+            return NULL ;
+        states[f.end].pattern = i ;
+        states[start].epsilon.push_back (f.start) ;
+    }
+
+    DFA *dfa = new DFA ;
+
+    /* Split the bytes into classes: two bytes share a class if every
+       character edge in the automaton treats them alike.
+     */
+    memset (dfa->byteClass, 0, sizeof(dfa->byteClass)) ;
+    dfa->numClasses = 1 ;
+    for (size_t s = 0; s < states.size(); s ++) {
+        if (states[s].next < 0)
+            continue ;
+        map<pair<int,bool>, int> refined ;
+        int numRefined = 0 ;
+        for (int ch = 0; ch < 256; ch ++) {
+            pair<int,bool> key (dfa->byteClass[ch], states[s].chars.test(ch)) ;
+            map<pair<int,bool>, int>::iterator it = refined.find (key) ;
+            if (it == refined.end())
+                it = refined.insert (make_pair (key, numRefined ++)).first ;
+            dfa->byteClass[ch] = it->second ;
+        }
+        dfa->numClasses = numRefined ;
+    }
+    vector<int> representative (dfa->numClasses) ;
+    for (int ch = 255; ch >= 0; ch --)
+        representative[dfa->byteClass[ch]] = ch ;
+
+    // The subset construction.
+    map<vector<int>, int> known ;
+    vector<vector<int> > pending ;
+
+    vector<int> startSet (1, start) ;
+    closure (states, startSet) ;
+    known[startSet] = 0 ;
+    pending.push_back (startSet) ;
+
+    for (size_t d = 0; d < pending.size(); d ++) {
+        vector<int> current = pending[d] ;
+
+        int winner = -1 ;
+        for (size_t i = 0; i < current.size(); i ++) {
+            int p = states[current[i]].pattern ;
+            if (p >= 0 && (winner < 0 || p < winner))
+                winner = p ;
+        }
+        dfa->accepting.push_back (winner) ;
+
+        for (int c = 0; c < dfa->numClasses; c ++) {
+            int ch = representative[c] ;
+            vector<int> target ;
+            for (size_t i = 0; i < current.size(); i ++) {
+                const NFAState &st = states[current[i]] ;
+                if (st.next >= 0 && st.chars.test(ch))
+                    target.push_back (st.next) ;
+            }
+            if (target.empty() || ch == 0) {
+                dfa->transitions.push_back (-1) ;
+                continue ;
+            }
+            closure (states, target) ;
+            map<vector<int>, int>::iterator it = known.find (target) ;
+            if (it == known.end()) {
+                it = known.insert (make_pair (target, (int) pending.size())).first ;
+                pending.push_back (target) ;
+            }
+            dfa->transitions.push_back (it->second) ;
+        }
+    }
+    dfa->numStates = pending.size() ;
+    return dfa ;
+}
+
+/* Returns the length of the longest non-empty prefix of [text]
+   matched by one of the patterns, or 0 if there is none.  The index
+   of the pattern that matched is stored in [pattern], and, if it is
+   not NULL, the number of characters that were looked at to decide
+   (counting the terminating '\0') in [examined].
+ */
+int matchDFA (const DFA *dfa, const char *text, int *pattern, int *examined) {
+    const int *transitions = &dfa->transitions[0] ;
+    const int *accepting = &dfa->accepting[0] ;
+    const unsigned char *byteClass = dfa->byteClass ;
+    const int numClasses = dfa->numClasses ;
+
+    int state = 0 ;
+    int longest = 0 ;
+    *pattern = -1 ;
+    int i = 0 ;
+    for ( ; text[i] != '\0'; i ++) {
+        state = transitions[state * numClasses + byteClass[(unsigned char) text[i]]] ;
+        if (state < 0)
+            break ;
+        if (accepting[state] >= 0) {
+            longest = i + 1 ;
+            *pattern = accepting[state] ;
+        }
+    }
+    if (examined != NULL)
+        *examined = i + 1 ;
+    return longest ;
+}
@@ -0,0 +1,40 @@
+/* dfa.h
+
+   This file declares the [DFA] class and the functions [makeDFA] and
+   [matchDFA].
+
+   A DFA is compiled from a prioritized list of POSIX extended regular
+   expressions, such as the token patterns used by the Scanner.  A
+   single call to [matchDFA] finds the longest prefix of the text that
+   is matched by any of the patterns; when several patterns match a
+   prefix of that length, the one listed first wins.  This is the same
+   maximal-munch rule the Scanner applies when it tries each regex in
+   turn, but the text is examined only once.
+ */
+#ifndef DFA_H
+#define DFA_H
+
+#include <stddef.h>
+#include <vector>
+
+class DFA {
+public:
+    int numStates ;
+    int numClasses ;
+
+    // Bytes that no pattern distinguishes share a column in the table.
+    unsigned char byteClass[256] ;
+
+    // Next state for state s on byte class c is transitions[s*numClasses+c],
+    // or -1 if no pattern can match any longer prefix.
+    std::vector<int> transitions ;
+
+    // Index of the winning pattern if the state accepts, otherwise -1.
+    std::vector<int> accepting ;
+} ;
+
+DFA *makeDFA (const char **patterns, int numPatterns) ;
+
+int matchDFA (const DFA *dfa, const char *text, int *pattern, int *examined = NULL) ;
+
+#endif /* DFA_H */
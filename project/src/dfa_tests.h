@@ -0,0 +1,63 @@
+#include <cxxtest/TestSuite.h>
+#include "dfa.h"
+
+using namespace std ;
+
+class DFATestSuite : public CxxTest::TestSuite
+{
+public:
+
+    // Tests for makeDFA and matchDFA
+    // --------------------------------------------------
+    /* These tests ensure that makeDFA and matchDFA work as expected,
+       independently of the scanner.
+     */
+
+    void test_make_matchDFA_match ( void ) {
+        const char *patterns[] = { "^[0-9]+" } ;
+        DFA *dfa = makeDFA (patterns, 1) ;
+        TS_ASSERT (dfa) ;
+        int pattern ;
+        TS_ASSERT_EQUALS (matchDFA (dfa, "123 ", &pattern), 3) ;
+        TS_ASSERT_EQUALS (pattern, 0) ;
+    }
+
+    void test_make_matchDFA_no_match ( void ) {
+        const char *patterns[] = { "^[0-9]+" } ;
+        DFA *dfa = makeDFA (patterns, 1) ;
+        TS_ASSERT (dfa) ;
+        int pattern ;
+        TS_ASSERT_EQUALS (matchDFA (dfa, " 123 ", &pattern), 0) ;
+        TS_ASSERT_EQUALS (pattern, -1) ;
+    }
+
+    // The longest match wins, and the first pattern wins a tie.
+    void test_matchDFA_longest_then_first ( void ) {
+        const char *patterns[] = { "^in", "^[a-z]+", "^i" } ;
+        DFA *dfa = makeDFA (patterns, 3) ;
+        TS_ASSERT (dfa) ;
+        int pattern ;
+        TS_ASSERT_EQUALS (matchDFA (dfa, "in ", &pattern), 2) ;
+        TS_ASSERT_EQUALS (pattern, 0) ;
+        TS_ASSERT_EQUALS (matchDFA (dfa, "interval ", &pattern), 8) ;
+        TS_ASSERT_EQUALS (pattern, 1) ;
+        TS_ASSERT_EQUALS (matchDFA (dfa, "i ", &pattern), 1) ;
+        TS_ASSERT_EQUALS (pattern, 1) ;
+    }
+
+    // As with regcomp, '\' is an ordinary character in a bracket.
+    void test_matchDFA_bracket_backslash ( void ) {
+        const char *patterns[] = { "^/\\*([^\\*]|\\*+[^\\*/])*\\*+/" } ;
+        DFA *dfa = makeDFA (patterns, 1) ;
+        TS_ASSERT (dfa) ;
+        int pattern ;
+        TS_ASSERT_EQUALS (matchDFA (dfa, "/* ab **/ x */", &pattern), 9) ;
+        TS_ASSERT_EQUALS (matchDFA (dfa, "/* a\\b */", &pattern), 0) ;
+    }
+
+    void test_makeDFA_bad_pattern ( void ) {
+        const char *patterns[] = { "^(ab" } ;
+        TS_ASSERT (makeDFA (patterns, 1) == NULL) ;
+    }
+
+} ;
@@ -0,0 +1,21 @@
+/* emitter.cpp
+
+   This file provides the [Emitter] class.
+ */
+
+#include "emitter.h"
+
+using namespace std ;
+
+void Emitter::flush () {
+	if (out != NULL && ! buffer.empty()) {
+		out->write (buffer.data(), buffer.size()) ;
+		buffer.clear () ;
+	}
+}
+
+string Emitter::take () {
+	string s ;
+	s.swap (buffer) ;
+	return s ;
+}
@@ -0,0 +1,50 @@
+/* emitter.h
+
+   This file declares the [Emitter] class, the output that the
+   emitUnparse and emitCppCode methods of the AST write to.
+
+   An Emitter appends everything to one buffer.  Made with an ostream,
+   it passes the buffer on each time it grows past [flushSize], so
+   the buffer is allocated once however long the output is.  Made
+   without one, the buffer holds the whole output, for [str] or
+   [take].
+ */
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include <string>
+#include <ostream>
+
+class Emitter {
+public:
+	Emitter () : out(NULL) { }
+	Emitter (std::ostream &o) : out(&o) { buffer.reserve (flushSize) ; }
+	~Emitter () { flush () ; }
+
+	Emitter &operator<< (const char *s) { buffer.append (s) ; check () ; return *this ; }
+	Emitter &operator<< (const std::string &s) { buffer.append (s) ; check () ; return *this ; }
+	Emitter &operator<< (char c) { buffer.push_back (c) ; check () ; return *this ; }
+
+	// Room for [n] chars, when the size of the output can be guessed.
+	void reserve (size_t n) { buffer.reserve (n) ; }
+
+	// Writes the buffer to the ostream, if there is one.
+	void flush () ;
+
+	// The output so far, and the output, leaving the Emitter empty.
+	const std::string &str () const { return buffer ; }
+	std::string take () ;
+
+	static const size_t flushSize = 64 * 1024 ;
+
+private:
+	Emitter (const Emitter &) ;
+	Emitter &operator= (const Emitter &) ;
+
+	void check () { if (out != NULL && buffer.size() >= flushSize) flush () ; }
+
+	std::string buffer ;
+	std::ostream *out ;
+} ;
+
+#endif /* EMITTER_H */
@@ -12,12 +12,14 @@
 #include "scanner.h"
 #include "parser.h"
 
+/* ExtTokens hold no per-token state: the parser keeps one ExtToken
+   for each terminal and uses it for every token of that terminal.
+   The tokens themselves are the TokenSpans in Parser::tokens.
+ */
 class ExtToken {
 public:
-    ExtToken (Parser *p, Token *t) 
-        : lexeme(t->lexeme), terminal(t->terminal), parser(p) { }
-    ExtToken (Parser *p, Token *t, std::string d) 
-        : lexeme(t->lexeme), terminal(t->terminal), parser(p), descStr(d) { }
+    ExtToken (Parser *p, tokenType t) 
+        : terminal(t), parser(p) { }
 
     virtual ~ExtToken () { } ;
 
@@ -28,21 +30,18 @@ public:
     virtual ParseResult led (ParseResult left) {
         throw ( parser->makeErrorMsg (parser->currToken->terminal) ) ;
     }
-    std::string lexeme ;
+
     tokenType terminal ;
-    ExtToken *next ;
     Parser *parser;
 
     virtual int lbp() { return 0 ; }
-    virtual std::string description() { return descStr ; }
+    const char *description() { return terminalDescriptions[terminal] ; }
 
 private:
     ExtToken () : parser(NULL) { } 
-    std::string descStr ;
 } ;
 
-ExtToken *extendToken (Parser *p, Token *tokens) ;
-ExtToken *extendTokenList (Parser *p, Token *tokens) ;
+ExtToken *extendToken (Parser *p, tokenType terminal) ;
 
 /* For each terminal symbol that will play some unique role in the
    semantic analysis of the program, we need a unique subclass of
@@ -50,10 +49,9 @@ ExtToken *extendTokenList (Parser *p, Token *tokens) ;
  */
 class NotOpToken : public ExtToken {
 public:
-    NotOpToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    NotOpToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     //TODO make real function
     ParseResult nud () { return parser->parseNotExpr(); }
-    std::string description() { return "notOp"; }
 } ;
 
 
@@ -61,131 +59,117 @@ public:
 // True Kwd
 class TrueKwdToken : public ExtToken {
 public:
-    TrueKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    TrueKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseTrueKwd (); }
-    std::string description() { return "true const"; }
 } ;
 
 // False Kwd
 class FalseKwdToken : public ExtToken {
 public:
-    FalseKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    FalseKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseFalseKwd (); }
-    std::string description() { return "false const"; }
 } ;
 
 // Int Const
 class IntConstToken : public ExtToken {
 public:
-    IntConstToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    IntConstToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseIntConst (); }
-    std::string description() { return "int const"; }
 } ;
 
 // Float Const
 class FloatConstToken : public ExtToken {
 public:
-    FloatConstToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    FloatConstToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseFloatConst (); }
-    std::string description() { return "float const"; }
 } ;
 
 // String Const
 class StringConstToken : public ExtToken {
 public:
-    StringConstToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    StringConstToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseStringConst (); }
-    std::string description() { return "string const"; }
 } ;
 
 // Char Const
 class CharConstToken : public ExtToken {
 public:
-    CharConstToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    CharConstToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseCharConst (); }
-    std::string description() { return "char const"; }
 } ;
 
 // Variable Name
 class VariableNameToken : public ExtToken {
 public:
-    VariableNameToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    VariableNameToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseVariableName (); }
-    std::string description() { return "variable name"; }
 } ;
 
 class IfToken:public ExtToken{
     public:
-    IfToken (Parser *p, Token *t) : ExtToken(p,t) { };
+    IfToken (Parser *p, tokenType t) : ExtToken(p,t) { };
     ParseResult nud () { return parser->parseIfExpr () ; }
-    std::string description() { return "'if'"; }
     int lbp() { return 80; }
 };
 class LetToken:public ExtToken{
     public:
-    LetToken (Parser *p, Token *t) : ExtToken(p,t) { };
+    LetToken (Parser *p, tokenType t) : ExtToken(p,t) { };
     ParseResult nud () { return parser->parseLetExpr () ; }
-    std::string description() { return "'let'"; }
     int lbp() { return 80; }
 };
     
 // Left Paren
 class LeftParenToken : public ExtToken {
 public:
-    LeftParenToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    LeftParenToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseNestedExpr () ; }
-    std::string description() { return "'('"; }
     int lbp() { return 80; }
 } ;
 
 // Plus Sign
 class PlusSignToken : public ExtToken {
 public:
-    PlusSignToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    PlusSignToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseAddition (left) ; 
     }
-    std::string description() { return "'+'"; }
     int lbp() { return 50; }
 } ;
 
 // Star
 class StarToken : public ExtToken {
 public:
-    StarToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    StarToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseMultiplication (left) ; 
     }
-    std::string description() { return "'*'"; }
     int lbp() { return 60; }
 } ;
 
 // Dash
 class DashToken : public ExtToken {
 public:
-    DashToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    DashToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseSubtraction (left) ; 
     }
-    std::string description() { return "'-'"; }
     int lbp() { return 50; }
 } ;
 
 // ForwardSlash
 class ForwardSlashToken : public ExtToken {
 public:
-    ForwardSlashToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    ForwardSlashToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseDivision (left) ; 
     }
-    std::string description() { return "/"; }
     int lbp() { return 60; }
 } ;
 
 // Relational Op
 class RelationalOpToken : public ExtToken {
 public:
-    RelationalOpToken (Parser *p, Token *t, std::string d) : ExtToken(p,t,d) { }
+    RelationalOpToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseRelationalExpr (left) ; 
     }
@@ -196,8 +180,7 @@ public:
 // End of File
 class EndOfFileToken : public ExtToken {
 public:
-    EndOfFileToken (Parser *p, Token *t) : ExtToken(p,t) { }
-    std::string description() { return "end of file"; }
+    EndOfFileToken (Parser *p, tokenType t) : ExtToken(p,t) { }
 } ;
 
 
@@ -206,7 +189,7 @@ public:
 // Left Angle
 class LeftAngleToken : public ExtToken {
 public:
-    LeftAngleToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    LeftAngleToken (Parser *p, tokenType t) : ExtToken(p,t) { }
 
     ParseResult led (ParseResult left) {
         return parser->parseRelationalExpr (left) ; 
@@ -219,7 +202,7 @@ public:
 // Right Angle
 class RightAngleToken : public ExtToken {
 public:
-    RightAngleToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    RightAngleToken (Parser *p, tokenType t) : ExtToken(p,t) { }
 
     ParseResult led (ParseResult left) {
         return parser->parseRelationalExpr (left) ; 
@@ -234,21 +217,21 @@ public:
 // In Kwd
 class InKwdToken : public ExtToken {
 public:
-    InKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    InKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'In'"; }
 } ;
 
 // End Kwd
 class EndKwdToken : public ExtToken {
 public:
-    EndKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    EndKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'End'"; }
 } ;
 
 // If Kwd
 class IfKwdToken : public ExtToken {
 public:
-    IfKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    IfKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseIfThenElse (); }
     std::string description() { return "'if'"; }
 } ;
@@ -256,21 +239,21 @@ public:
 // Then Kwd
 class ThenKwdToken : public ExtToken {
 public:
-    ThenKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    ThenKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'then'"; }
 } ;
 
 // Else Kwd
 class ElseKwdToken : public ExtToken {
 public:
-    ElseKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    ElseKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'else'"; }
 } ;
 
 // Print Kwd
 class PrintKwdToken : public ExtToken {
 public:
-    PrintKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    PrintKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parsePrintExpr (); }
     std::string description() { return "'print'"; }
 } ;
@@ -278,7 +261,7 @@ public:
 // Read Kwd
 class ReadKwdToken : public ExtToken {
 public:
-    ReadKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    ReadKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseReadExpr (); }
     std::string description() { return "'read'"; }
 } ;
@@ -286,7 +269,7 @@ public:
 // Write Kwd
 class WriteKwdToken : public ExtToken {
 public:
-    WriteKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    WriteKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseWriteExpr (); }
     std::string description() { return "'write'"; }
 } ;
@@ -294,35 +277,35 @@ public:
 // Integer Kwd
 class IntegerKwdToken : public ExtToken {
 public:
-    IntegerKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    IntegerKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'Integer'"; }
 } ;
 
 // Float Kwd
 class FloatKwdToken : public ExtToken {
 public:
-    FloatKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    FloatKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'Float'"; }
 } ;
 
 // Boolean Kwd
 class BooleanKwdToken : public ExtToken {
 public:
-    BooleanKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    BooleanKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'Boolean'"; }
 } ;
 
 // String Kwd
 class StringKwdToken : public ExtToken {
 public:
-    StringKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    StringKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'String'"; }
 } ;
 
 // True Kwd
 class TrueKwdToken : public ExtToken {
 public:
-    TrueKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    TrueKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseTrueKwd (); }
     std::string description() { return "'True'"; }
 } ;
@@ -330,7 +313,7 @@ public:
 // False Kwd
 class FalseKwdToken : public ExtToken {
 public:
-    FalseKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    FalseKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseFalseKwd (); }
     std::string description() { return "'False'"; }
 } ;
@@ -338,7 +321,7 @@ public:
 // Head Kwd
 class HeadKwdToken : public ExtToken {
 public:
-    HeadKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    HeadKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseHeadExpr (); }
     std::string description() { return "'Head'"; }
 } ;
@@ -346,7 +329,7 @@ public:
 // Tail Kwd
 class TailKwdToken : public ExtToken {
 public:
-    TailKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    TailKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseTailExpr (); }
     std::string description() { return "'Tail'"; }
 } ;
@@ -354,7 +337,7 @@ public:
 // Null Kwd
 class NullKwdToken : public ExtToken {
 public:
-    NullKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    NullKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseNullExpr (); }
     std::string description() { return "'Null'"; }
 } ;
@@ -362,7 +345,7 @@ public:
 // Map Kwd
 class MapKwdToken : public ExtToken {
 public:
-    MapKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    MapKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseMapExpr (); }
     std::string description() { return "'Map'"; }
 } ;
@@ -370,7 +353,7 @@ public:
 // Filter Kwd
 class FilterKwdToken : public ExtToken {
 public:
-    FilterKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    FilterKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseFilterExpr (); }
     std::string description() { return "filter"; }
 } ;
@@ -378,7 +361,7 @@ public:
 // Fold Kwd
 class FoldKwdToken : public ExtToken {
 public:
-    FoldKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    FoldKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseFoldExpr (); }
     std::string description() { return "fold"; }
 } ;
@@ -386,7 +369,7 @@ public:
 // Zip Kwd
 class ZipKwdToken : public ExtToken {
 public:
-    ZipKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    ZipKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseZipExpr (); }
     std::string description() { return "zip"; }
 } ;
@@ -395,7 +378,7 @@ public:
 // Int Const
 class IntConstToken : public ExtToken {
 public:
-    IntConstToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    IntConstToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseIntConst (); }
     std::string description() { return "integer constant"; }
 } ;
@@ -403,7 +386,7 @@ public:
 // Float Const
 class FloatConstToken : public ExtToken {
 public:
-    FloatConstToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    FloatConstToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseFloatConst (); }
     std::string description() { return "floating point constant"; }
 } ;
@@ -411,7 +394,7 @@ public:
 // String Const
 class StringConstToken : public ExtToken {
 public:
-    StringConstToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    StringConstToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseStringConst (); }
     std::string description() { return "string constant"; }
 } ;
@@ -423,7 +406,7 @@ public:
 // Percent
 class PercentToken : public ExtToken {
 public:
-    PercentToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    PercentToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseModulus (left) ; 
     }
@@ -435,7 +418,7 @@ public:
 // Plus Plus
 class PlusPlusToken : public ExtToken {
 public:
-    PlusPlusToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    PlusPlusToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseAppendExpr (left) ; 
     }
@@ -446,7 +429,7 @@ public:
 // Dot Dot
 class DotDotToken : public ExtToken {
 public:
-    DotDotToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    DotDotToken (Parser *p, tokenType t) : ExtToken(p,t) { }
 //    ParseResult led (ParseResult left) {
 //        return parser->parseDotDotExpr (left) ; 
 //    }
@@ -459,7 +442,7 @@ public:
 // BackSlash
 class BackSlashToken : public ExtToken {
 public:
-    BackSlashToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    BackSlashToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseLambdaExpr () ;  }
     std::string description() { return "'\'"; }
 } ;
@@ -470,14 +453,14 @@ public:
 // Colon Colon
 class ColonColonToken : public ExtToken {
 public:
-    ColonColonToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    ColonColonToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'::'"; }
 } ;
 
 // Colon
 class ColonToken : public ExtToken {
 public:
-    ColonToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    ColonToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult led (ParseResult left) {
         return parser->parseConsExpr (left) ; 
     }
@@ -488,20 +471,20 @@ public:
 // Semicolon
 class SemiColonToken : public ExtToken {
 public:
-    SemiColonToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    SemiColonToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "';'"; }
 } ;
 // Equals Sign
 class EqualsSignToken : public ExtToken {
 public:
-    EqualsSignToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    EqualsSignToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'='"; }
 } ;
 
 // Tuple Op
 class TupleOpToken : public ExtToken {
 public:
-    TupleOpToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    TupleOpToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     ParseResult nud () { return parser->parseProjectionExpr (); }
     std::string description() { return "tuple projection operator"; }
 } ;
@@ -514,14 +497,14 @@ public:
 // Name Kwd
 class NameKwdToken : public ExtToken {
 public:
-    NameKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    NameKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'name'"; }
 } ;
 
 // Platform Kwd
 class PlatformKwdToken : public ExtToken {
 public:
-    PlatformKwdToken (Parser *p, Token *t) : ExtToken(p,t) { }
+    PlatformKwdToken (Parser *p, tokenType t) : ExtToken(p,t) { }
     std::string description() { return "'platform'"; }
 } ;
 */
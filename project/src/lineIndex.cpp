@@ -0,0 +1,63 @@
+/* lineIndex.cpp
+
+   This file provides the [LineIndex] class and [countNewlines].
+ */
+
+#include <algorithm>
+#include <string.h>
+
+#include "lineIndex.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std ;
+
+/* Returns the number of '\n' chars in the first [length] chars of
+   [text].  SSE2 is part of every x86-64 CPU, so no dispatch is needed.
+ */
+int countNewlines (const char *text, int length) {
+    int count = 0 ;
+    int i = 0 ;
+#ifdef __SSE2__
+    const __m128i newline = _mm_set1_epi8 ('\n') ;
+    for ( ; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128 ((const __m128i *) (text + i)) ;
+        count += __builtin_popcount (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, newline))) ;
+    }
+#endif
+    for ( ; i < length; i ++)
+        count += text[i] == '\n' ;
+    return count ;
+}
+
+void LineIndex::build () {
+    int length = strlen (text) ;
+    lineStarts.clear () ;
+    lineStarts.reserve (countNewlines (text, length) + 1) ;
+    lineStarts.push_back (0) ;
+    const char *p = text ;
+    const char *end = text + length ;
+    while ((p = (const char *) memchr (p, '\n', end - p)) != NULL) {
+        p ++ ;
+        lineStarts.push_back (p - text) ;
+    }
+    built = true ;
+}
+
+void LineIndex::position (int offset, int *line, int *column) {
+    if (! built)
+        build () ;
+    // The last line that starts at or before [offset].
+    int i = upper_bound (lineStarts.begin(), lineStarts.end(), offset) 
+            - lineStarts.begin() - 1 ;
+    *line = i + 1 ;
+    *column = offset - lineStarts[i] + 1 ;
+}
+
+int LineIndex::numLines () {
+    if (! built)
+        build () ;
+    return lineStarts.size () ;
+}
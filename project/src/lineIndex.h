@@ -0,0 +1,40 @@
+/* lineIndex.h
+
+   This file declares the [LineIndex] class, which maps offsets in a
+   text, such as those in TokenSpans, to line and column numbers.
+
+   The table of line starts is only built the first time a position is
+   asked for, so parsing a correct program never pays for it.  It is
+   built by counting the newlines 16 bytes at a time to size the table
+   and then finding each one with memchr; each lookup is then a binary
+   search.
+ */
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <stddef.h>
+#include <vector>
+
+class LineIndex {
+public:
+    LineIndex () : text(NULL), built(false) { }
+
+    // Forgets the table; the next lookup builds one for [t].
+    void reset (const char *t) { text = t ; built = false ; }
+
+    // Line and column numbers start at 1.  A column counts chars, so a
+    // tab counts as one.
+    void position (int offset, int *line, int *column) ;
+    int numLines () ;
+
+private:
+    void build () ;
+
+    const char *text ;
+    bool built ;
+    std::vector<int> lineStarts ;
+} ;
+
+int countNewlines (const char *text, int length) ;
+
+#endif /* LINEINDEX_H */
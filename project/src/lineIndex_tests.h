@@ -0,0 +1,51 @@
+#include <cxxtest/TestSuite.h>
+#include "lineIndex.h"
+
+#include <string>
+
+using namespace std ;
+
+class LineIndexTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    // Tests for countNewlines and LineIndex
+    // --------------------------------------------------
+
+    void test_countNewlines ( void ) {
+        TS_ASSERT_EQUALS (countNewlines ("", 0), 0) ;
+        TS_ASSERT_EQUALS (countNewlines ("a\nb\n", 4), 2) ;
+        string text ;
+        for (int i = 0; i < 100; i ++)
+            text += "0123456789abcde\n\n" ;
+        TS_ASSERT_EQUALS (countNewlines (text.c_str(), text.size()), 200) ;
+        TS_ASSERT_EQUALS (countNewlines (text.c_str(), 16), 1) ;
+    }
+
+    void test_position ( void ) {
+        LineIndex lines ;
+        lines.reset ("ab\n\ncd\n") ;
+        int line, column ;
+        lines.position (0, &line, &column) ;
+        TS_ASSERT (line == 1 && column == 1) ;
+        lines.position (2, &line, &column) ;
+        TS_ASSERT (line == 1 && column == 3) ;
+        lines.position (3, &line, &column) ;
+        TS_ASSERT (line == 2 && column == 1) ;
+        lines.position (5, &line, &column) ;
+        TS_ASSERT (line == 3 && column == 2) ;
+        lines.position (7, &line, &column) ;
+        TS_ASSERT (line == 4 && column == 1) ;
+        TS_ASSERT_EQUALS (lines.numLines(), 4) ;
+    }
+
+    // After reset the table is rebuilt for the new text.
+    void test_reset ( void ) {
+        LineIndex lines ;
+        lines.reset ("a\nb") ;
+        TS_ASSERT_EQUALS (lines.numLines(), 2) ;
+        lines.reset ("abc") ;
+        TS_ASSERT_EQUALS (lines.numLines(), 1) ;
+    }
+
+} ;
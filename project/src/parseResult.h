@@ -11,14 +11,27 @@
 #include "AST.h"
 
 #include <string>
+#include <vector>
 
 
 class ParseResult {
 public:
     ParseResult() ;
     std::string errors ;
+    // Every error, in order, when the Parser recovers from errors.
+    std::vector<std::string> diagnostics ;
+    // Every parse method returns a ParseResult, so [ast] may be a Root,
+    // Stmts, Stmt, Expr or VarName.  Its kind() tag already says which,
+    // and the accessors below check it, so a union of typed pointers
+    // would only repeat the tag.
     Node *ast ;
     bool ok ;
+
+    // [ast] as the class a parse method expects, or NULL if it is not.
+    Stmts *stmts () const { return ast ? ast->asStmts() : NULL ; }
+    Stmt *stmt () const { return ast ? ast->asStmt() : NULL ; }
+    Expr *expr () const { return ast ? ast->asExpr() : NULL ; }
+    VarName *varName () const { return ast ? ast->asVarName() : NULL ; }
 } ;
 
 #endif /* PARSER_RESULT_H */
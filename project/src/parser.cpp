@@ -52,30 +52,67 @@ using namespace std ;
 Parser::~Parser() {
     if (s) delete s ;
 
-    ExtToken *extTokenToDelete ;
-    currToken = tokens ;
-    while (currToken) {
-        extTokenToDelete = currToken ;
-        currToken = currToken->next ;
-        delete extTokenToDelete ;
-    }
+    for (int t = 0; t <= lexicalError; t ++)
+        delete extTokens[t] ;
+}
 
-    Token *tokenToDelete ;
-    Token *currScannerToken = stokens ;
-    while (currScannerToken) {
-        tokenToDelete = currScannerToken ;
-        currScannerToken = currScannerToken->next ;
-        delete tokenToDelete ;
-    }
 
+/* The table-driven form of the ExtToken subclasses in extToken.h.  A
+   terminal with no nud (or led) handler is a syntax error in that
+   position, just as with the ExtToken defaults.
+ */
+typedef ParseResult (Parser::*nudHandler) () ;
+typedef ParseResult (Parser::*ledHandler) (ParseResult) ;
+
+struct PrattTable {
+    int lbp[lexicalError+1] ;
+    nudHandler nud[lexicalError+1] ;
+    ledHandler led[lexicalError+1] ;
+} ;
+
+static constexpr PrattTable makePrattTable () {
+    PrattTable t = { } ;
+
+    t.nud[trueKwd] = &Parser::parseTrueKwd ;
+    t.nud[falseKwd] = &Parser::parseFalseKwd ;
+    t.nud[intConst] = &Parser::parseIntConst ;
+    t.nud[floatConst] = &Parser::parseFloatConst ;
+    t.nud[stringConst] = &Parser::parseStringConst ;
+    t.nud[variableName] = &Parser::parseVariableName ;
+    t.nud[notOp] = &Parser::parseNotExpr ;
+
+    t.nud[ifKwd] = &Parser::parseIfExpr ;      t.lbp[ifKwd] = 80 ;
+    t.nud[letKwd] = &Parser::parseLetExpr ;    t.lbp[letKwd] = 80 ;
+    t.nud[leftParen] = &Parser::parseNestedExpr ; t.lbp[leftParen] = 80 ;
+
+    t.led[plusSign] = &Parser::parseAddition ;        t.lbp[plusSign] = 50 ;
+    t.led[dash] = &Parser::parseSubtraction ;         t.lbp[dash] = 50 ;
+    t.led[star] = &Parser::parseMultiplication ;      t.lbp[star] = 60 ;
+    t.led[forwardSlash] = &Parser::parseDivision ;    t.lbp[forwardSlash] = 60 ;
+
+    const tokenType relationalOps[] = { equalsEquals, lessThan, greaterThan,
+                                        lessThanEqual, greaterThanEqual, notEquals } ;
+    for (int i = 0; i < 6; i ++) {
+        t.led[relationalOps[i]] = &Parser::parseRelationalExpr ;
+        t.lbp[relationalOps[i]] = 30 ;
+    }
+    return t ;
 }
 
+static constexpr PrattTable prattTable = makePrattTable () ;
 
-/*! \brief Default constructor. Sets everything to NULL
+/*! \brief Default constructor. Sets everything to NULL and
+    creates the ExtToken shared by all tokens of each terminal.
+
+    @param d How parseExpr finds the nud, led and lbp of a token
 */
-Parser::Parser ( ) { 
-    currToken = NULL; prevToken = NULL ; tokens = NULL; 
-    s = NULL; stokens = NULL; 
+Parser::Parser ( prattDispatchType d ) { 
+    dispatch = d ;
+    currToken = NULL; prevToken = NULL ; 
+    s = NULL; text = NULL; windowBase = 0; scanOffset = 0; 
+    maxDepth = defaultMaxDepth; depth = 0; recover = false; 
+    for (int t = 0; t <= lexicalError; t ++)
+        extTokens[t] = extendToken (this, (tokenType) t) ;
 }
 
 /*! \brief Parses the program
@@ -84,31 +121,131 @@ Parser::Parser ( ) {
     input text. Second, it checks to make sure that the 
     tokens, and therfore the program, is well-formed 
     without any lexical errors. Third and final, 
-    creates a tree out of the tokens.
+    creates a tree out of the tokens.  The tree of the previous
+    parse with this Parser is freed.
 
     @return ParseResult 
 */
 ParseResult Parser::parse (const char *text) {
+    return parseText (text, false) ;
+}
+
+/*! \brief Parses the program, scanning tokens only as they are needed
+
+    Rather than scanning the whole text before parsing, the parser
+    pulls tokens from the scanner into a small window.  Memory for
+    tokens does not grow with the size of the text, and a syntax
+    error stops scanning near the token where it was found.  Tokens
+    that have left the window cannot be returned to with rewind.
+
+    @return ParseResult 
+*/
+ParseResult Parser::parseStream (const char *text) {
+    return parseText (text, true) ;
+}
+
+/*! \brief Frees the tree and tokens of the previous parse
+
+    The arena runs the destructors of the old nodes but keeps every
+    block it has allocated, for the next tree.  [tokens] is cleared
+    but keeps its capacity, whether it held every token of a parse or
+    the window of a parseStream, and the Scanner is kept too.  So a
+    Parser used for many texts stops allocating once it has seen its
+    largest one.  parse and parseStream call this first.
+*/
+void Parser::reset () {
+    arena.release() ;
+    tokens.clear() ;
+    text = NULL ;
+    lines.reset (NULL) ;
+    windowBase = 0 ;
+    scanOffset = 0 ;
+    currToken = NULL ;
+    prevToken = NULL ;
+    depth = 0 ;
+    diagnostics.clear() ;
+}
+
+/*! \brief Counts one more level of nesting
+
+    Each parseExpr and parseStmt holds a NestingGuard for as long as
+    it runs, so parentheses, let, if, ! and blocks each count a level.
+    Past [maxDepth] levels the parse stops with an error.  A chain of
+    operators such as a + b + c is built by the loop in parseExpr and
+    is not nesting: the emitters and visitors walk it with a loop too.
+*/
+void Parser::enterNested () {
+    if (depth >= maxDepth) {
+        char msg[64] ;
+        snprintf (msg, sizeof msg, "Nesting deeper than %d levels", maxDepth) ;
+        throw ( makeErrorMsg (msg) + " at " + location (currToken) ) ;
+    }
+    depth ++ ;
+}
+
+class NestingGuard {
+public:
+    NestingGuard (Parser *p) : p(p), outer(p->depth) { p->enterNested () ; }
+    ~NestingGuard () { p->depth = outer ; }
+private:
+    Parser *p ;
+    int outer ;
+} ;
+
+ParseResult Parser::parseText (const char *text, bool streaming) {
     assert (text != NULL) ;
 
+    reset() ;
     ParseResult pr ;
     try {
-        s = new Scanner() ;
-        stokens = s->scan (text) ;        
-        tokens = extendTokenList ( this, stokens ) ;
-
-        assert (tokens != NULL) ;
-        currToken = tokens ;
+        // The Scanner only refers to the shared, precompiled token
+        // tables, so one is kept for all calls to parse.
+        if (s == NULL)
+            s = new Scanner() ;
+        this->text = text ;
+        lines.reset (text) ;
+        if (streaming)
+            tokens.push_back (s->scanNext (text, &scanOffset)) ;
+        else
+            s->scanSpans (text, tokens) ;
+
+        assert (! tokens.empty()) ;
+        currToken = &tokens[0] ;
+        prevToken = NULL ;
         pr = parseProgram( ) ;
     }
     catch (string errMsg) {
+        // An empty message means the error is already recorded.
+        if (! errMsg.empty())
+            diagnostics.push_back (errMsg) ;
+    }
+    if (! diagnostics.empty()) {
         pr.ok = false ;
-        pr.errors = errMsg ;
+        pr.errors = diagnostics[0] ;
+        for (size_t i = 1; i < diagnostics.size(); i ++)
+            pr.errors += "\n" + diagnostics[i] ;
+        pr.diagnostics = diagnostics ;
         pr.ast = NULL ;
     }
     return pr ;
 }
 
+/*! \brief Records an error and skips to where parsing can go on
+
+    Tokens are skipped up to and including the next ';', or up to the
+    next '}', which is left for the enclosing block to match.  If the
+    end of the text comes first nothing more can be parsed, so an empty
+    message is thrown to end the parse.
+*/
+void Parser::resync (const string &errMsg) {
+    diagnostics.push_back (errMsg) ;
+    while (! nextIs(semiColon) && ! nextIs(rightCurly) && ! nextIs(endOfFile))
+        nextToken() ;
+    if (nextIs(endOfFile))
+        throw ( string() ) ;
+    attemptMatch(semiColon) ;
+}
+
 /* 
  * parse methods for non-terminal symbols
  * --------------------------------------
@@ -131,20 +268,20 @@ ParseResult Parser::parseProgram () {
     // root
     // Program ::= varName '(' ')' '{' Stmts '}' 
     match(variableName) ;
-    string name( prevToken->lexeme ) ;
-    VarName* varname = new VarName(name) ;
+    string name( prevToken->lexeme(text) ) ;
+    VarName* varname = arena.make<VarName>(name) ;
     match(leftParen) ;
     match(rightParen) ;
     match(leftCurly);
     ParseResult prStmts = parseStmts() ;
     Stmts* s;
     if (prStmts.ast) {
-        s = dynamic_cast<Stmts *>(prStmts.ast) ;
+        s = prStmts.stmts() ;
     }
     match(rightCurly);
     match(endOfFile) ;
     
-    pr.ast = new Root(varname, s) ;
+    pr.ast = arena.make<Root>(varname, s) ;
 
     return pr ;
 }
@@ -167,7 +304,7 @@ ParseResult Parser::parseMatrixDecl () {
 
     match(matrixKwd);
     match(variableName) ;
-    varName1 = new VarName(prevToken->lexeme);
+    varName1 = arena.make<VarName>(prevToken->lexeme(text));
 
     // Decl ::= 'Matrix' varName '[' Expr ',' Expr ']' varName ',' varName  '=' Expr ';'
     if(attemptMatch(leftSquare)){
@@ -182,22 +319,22 @@ ParseResult Parser::parseMatrixDecl () {
         ParseResult exPr3 = parseExpr(0);
 
         if (exPr1.ast && exPr2.ast && exPr3.ast && namePr1.ast and namePr2.ast) {
-            ex1 = dynamic_cast<Expr *>(exPr1.ast) ;
-            ex2 = dynamic_cast<Expr *>(exPr2.ast) ;
-            ex3 = dynamic_cast<Expr *>(exPr3.ast) ;
-            varName2 = dynamic_cast<VarName *>(namePr1.ast) ;
-            varName3 = dynamic_cast<VarName *>(namePr2.ast) ;
+            ex1 = exPr1.expr() ;
+            ex2 = exPr2.expr() ;
+            ex3 = exPr3.expr() ;
+            varName2 = namePr1.varName() ;
+            varName3 = namePr2.varName() ;
 
-            pr.ast = new MatrixAdvDecl(varName1, varName2, varName3, ex1, ex2, ex3);
+            pr.ast = arena.make<MatrixAdvDecl>(varName1, varName2, varName3, ex1, ex2, ex3);
         }
     }
     // Decl ::= 'Matrix' varName '=' Expr ';'
     else if(attemptMatch(assign)){
         ParseResult exPr = parseExpr(0);
         if (exPr.ast) {
-            ex1 = dynamic_cast<Expr *>(exPr.ast) ;
+            ex1 = exPr.expr() ;
         }
-        pr.ast = new MatrixDecl(varName1, ex1);
+        pr.ast = arena.make<MatrixDecl>(varName1, ex1);
     }
     else{
         throw ( (string) "Bad Syntax of Matrix Decl in in parseMatrixDecl" ) ;
@@ -221,15 +358,15 @@ ParseResult Parser::parseStandardDecl(){
     string keyword ;
     if ( attemptMatch(intKwd) || attemptMatch(floatKwd) || attemptMatch(stringKwd) || attemptMatch(boolKwd) ) {
         // Type ::= intKwd | floatKwd | strKwd | boolKwd
-        keyword = prevToken->lexeme;
+        keyword = prevToken->lexeme(text);
     } else {
         throw ( (string) "Invalid keyword in parseStandardDecl" ) ;
     }
 
     match(variableName) ;
-    VarName* varName = new VarName(prevToken->lexeme);
+    VarName* varName = arena.make<VarName>(prevToken->lexeme(text));
     match(semiColon) ;
-    pr.ast = new StandardDecl(keyword, varName);
+    pr.ast = arena.make<StandardDecl>(keyword, varName);
     return pr ;
 }
 
@@ -268,23 +405,22 @@ ParseResult Parser::parseDecl () {
 */
 ParseResult Parser::parseStmts () {
     ParseResult pr ;
-    if ( ! nextIs(rightCurly) && !nextIs(inKwd)  ) {
-        // Stmts ::= Stmt Stmts
-        ParseResult prStmt = parseStmt() ;
-        ParseResult prStmts = parseStmts() ;
-    	Stmt* s;
-    	Stmts* ss;
-    	if (prStmt.ast && prStmts.ast) {
-     	    s = dynamic_cast<Stmt *>(prStmt.ast) ;
-    	    ss = dynamic_cast<Stmts *>(prStmts.ast) ;
-    	}
-	    pr.ast = new StmtStmts(s, ss);
-    }
-    else {
-        // Stmts ::= 
-        // nothing to match.
-	    pr.ast = new EmptyStmts() ;
+    StmtList *list = arena.make<StmtList>() ;
+    // Stmts ::= Stmt Stmts | <<empty>>, as a loop, so that a long
+    // sequence does not need a stack frame per statement.
+    while ( ! nextIs(rightCurly) && !nextIs(inKwd)  ) {
+        try {
+            ParseResult prStmt = parseStmt() ;
+            if (prStmt.ast)
+                list->append(prStmt.stmt()) ;
+        }
+        catch (string errMsg) {
+            if (! recover || errMsg.empty())
+                throw ;
+            resync (errMsg) ;
+        }
     }
+    pr.ast = list ;
     return pr ;
 }
 
@@ -298,6 +434,7 @@ ParseResult Parser::parseStmts () {
     @return ParseResult 
 */
 ParseResult Parser::parseStmt () {
+    NestingGuard guard (this) ;
     ParseResult pr ;
 
     //Stmt ::= Decl
@@ -310,9 +447,9 @@ ParseResult Parser::parseStmt () {
         ParseResult pr1 = parseStmts() ; 
         match(rightCurly);
         if (pr1.ast) {
-            stmts = dynamic_cast<Stmts *>(pr1.ast);
+            stmts = pr1.stmts();
         }
-        pr.ast = new StmtBlock(stmts);
+        pr.ast = arena.make<StmtBlock>(stmts);
     }   
     //Stmt ::= 'if' '(' Expr ')' Stmt
     //Stmt ::= 'if' '(' Expr ')' Stmt 'else' Stmt
@@ -326,25 +463,25 @@ ParseResult Parser::parseStmt () {
         ParseResult stmtPr1 = parseStmt();
 
         if (exPr.ast && stmtPr1.ast) {
-            ex = dynamic_cast<Expr *>(exPr.ast);
-            stmt1 = dynamic_cast<Stmt *>(stmtPr1.ast);
+            ex = exPr.expr();
+            stmt1 = stmtPr1.stmt();
         }
         
         if(attemptMatch(elseKwd)){
             ParseResult stmtPr2 = parseStmt();
             if (stmtPr2.ast) {
-                stmt2 = dynamic_cast<Stmt *>(stmtPr2.ast);
+                stmt2 = stmtPr2.stmt();
             }
-            pr.ast = new IfElseStmt(ex, stmt1, stmt2);
+            pr.ast = arena.make<IfElseStmt>(ex, stmt1, stmt2);
         } else {
-            pr.ast = new IfStmt(ex, stmt1);
+            pr.ast = arena.make<IfStmt>(ex, stmt1);
         }
 
     }
     //Stmt ::= varName '=' Expr ';'  | varName '[' Expr ',' Expr ']' '=' Expr ';'
     else if  ( attemptMatch (variableName) ) {
         Expr *ex1 = NULL, *ex2, *ex3;
-        VarName *varName = new VarName(prevToken->lexeme);
+        VarName *varName = arena.make<VarName>(prevToken->lexeme(text));
 
         if (attemptMatch ( leftSquare ) ) {
               ParseResult exPr1 = parseExpr(0);
@@ -352,23 +489,23 @@ ParseResult Parser::parseStmt () {
               ParseResult exPr2 = parseExpr (0) ;
               match  ( rightSquare ) ;
               if (exPr1.ast && exPr2.ast) {
-                ex1 = dynamic_cast<Expr *>(exPr1.ast);
-                ex2 = dynamic_cast<Expr *>(exPr2.ast);
+                ex1 = exPr1.expr();
+                ex2 = exPr2.expr();
               }
         }
         match(assign);
         ParseResult exPr3 = parseExpr(0);
         match(semiColon);
         if (exPr3.ast) {
-            ex3 = dynamic_cast<Expr *>(exPr3.ast);
+            ex3 = exPr3.expr();
         }
 
         if (ex1 != NULL) {
             //Stmt ::= varName '[' Expr ',' Expr ']' '=' Expr ';'
-            pr.ast = new MatrixAssignStmt(varName, ex1, ex2, ex3);
+            pr.ast = arena.make<MatrixAssignStmt>(varName, ex1, ex2, ex3);
         } else {
             //Stmt ::= varName '=' Expr ';'
-            pr.ast = new StandardAssignStmt(varName, ex3);
+            pr.ast = arena.make<StandardAssignStmt>(varName, ex3);
         }
 
     }
@@ -380,9 +517,9 @@ ParseResult Parser::parseStmt () {
         match (rightParen) ;
         match (semiColon) ;
         if (exPr.ast) {
-            ex = dynamic_cast<Expr *>(exPr.ast);
+            ex = exPr.expr();
         }
-        pr.ast = new PrintStmt(ex);
+        pr.ast = arena.make<PrintStmt>(ex);
     }
     //Stmt ::= 'for' '(' varName '=' Expr ':' Expr ')' Stmt
     else if ( attemptMatch (forKwd) ) {
@@ -392,7 +529,7 @@ ParseResult Parser::parseStmt () {
 
         match (leftParen) ;
         match (variableName) ;
-        varName = new VarName(prevToken->lexeme);
+        varName = arena.make<VarName>(prevToken->lexeme(text));
         match (assign) ;
         ParseResult ex1Pr = parseExpr (0) ;
         match (colon) ;
@@ -400,11 +537,11 @@ ParseResult Parser::parseStmt () {
         match (rightParen) ;
         ParseResult stmtPr = parseStmt () ;
         if (ex1Pr.ast && ex2Pr.ast && stmtPr.ast) {
-            ex1 = dynamic_cast<Expr *>(ex1Pr.ast);
-            ex2 = dynamic_cast<Expr *>(ex2Pr.ast);
-            stmt = dynamic_cast<Stmt *>(stmtPr.ast);
+            ex1 = ex1Pr.expr();
+            ex2 = ex2Pr.expr();
+            stmt = stmtPr.stmt();
         }
-        pr.ast = new ForStmt(varName, ex1, ex2, stmt);
+        pr.ast = arena.make<ForStmt>(varName, ex1, ex2, stmt);
     }
     //Stmt ::= 'while' '(' Expr ')' Stmt
     else if (attemptMatch(whileKwd)) {
@@ -415,10 +552,10 @@ ParseResult Parser::parseStmt () {
         match(rightParen);
         ParseResult stmtPr = parseStmt();
         if (exPr.ast && stmtPr.ast) {
-            ex = dynamic_cast<Expr *>(exPr.ast);
-            stmt = dynamic_cast<Stmt *>(stmtPr.ast);
+            ex = exPr.expr();
+            stmt = stmtPr.stmt();
         }
-        pr.ast = new WhileStmt(ex, stmt);
+        pr.ast = arena.make<WhileStmt>(ex, stmt);
     }
     //Stmt ::= ';
     else if ( attemptMatch (semiColon) ) {
@@ -442,19 +579,46 @@ ParseResult Parser::parseStmt () {
     @return ParseResult 
 */
 ParseResult Parser::parseExpr (int rbp) {
+    NestingGuard guard (this) ;
+    if (dispatch == tableDispatch) {
+        nudHandler nud = prattTable.nud[currToken->terminal] ;
+        if (nud == NULL)
+            throw ( makeErrorMsg (currToken->terminal) ) ;
+        ParseResult left = (this->*nud)() ;
+
+        while (rbp < prattTable.lbp[currToken->terminal]) {
+            ledHandler led = prattTable.led[currToken->terminal] ;
+            if (led == NULL)
+                throw ( makeErrorMsg (currToken->terminal) ) ;
+            left = (this->*led)(left) ;
+        }
+        return left ;
+    }
+
     /* Examine current token, without consuming it, to call its
        associated parse methods.  The ExtToken objects have 'nud' and
        'led' methods that are dispatchers that call the appropriate
        parse methods.*/
-    ParseResult left = currToken->nud() ;
+    ParseResult left = extToken(currToken)->nud() ;
    
-    while (rbp < currToken->lbp() ) {
-        left = currToken->led(left) ;
+    while (rbp < extToken(currToken)->lbp() ) {
+        left = extToken(currToken)->led(left) ;
     }
 
     return left ;
 }
 
+/*! \brief Left binding power of a terminal
+
+    @param tt tokenType whose binding power is wanted
+    @return int
+*/
+int Parser::lbp (tokenType tt) {
+    if (dispatch == tableDispatch)
+        return prattTable.lbp[tt] ;
+    return extTokens[tt]->lbp() ;
+}
+
 
 /*
  * parse methods for Expr productions
@@ -468,7 +632,7 @@ ParseResult Parser::parseExpr (int rbp) {
  ParseResult Parser::parseTrueKwd ( ) {
      ParseResult pr ;
      match ( trueKwd ) ;
-     pr.ast = new AnyConst(prevToken->lexeme);
+     pr.ast = arena.make<AnyConst>(prevToken->lexeme(text));
      return pr ;
  }
 
@@ -479,7 +643,7 @@ ParseResult Parser::parseExpr (int rbp) {
  ParseResult Parser::parseFalseKwd ( ) {
      ParseResult pr ;
      match ( falseKwd ) ;
-     pr.ast = new AnyConst(prevToken->lexeme);
+     pr.ast = arena.make<AnyConst>(prevToken->lexeme(text));
      return pr ;
  }
 
@@ -490,7 +654,7 @@ ParseResult Parser::parseExpr (int rbp) {
 ParseResult Parser::parseIntConst ( ) {
     ParseResult pr ;
     match ( intConst ) ; 
-    pr.ast = new AnyConst(prevToken->lexeme) ;
+    pr.ast = arena.make<AnyConst>(prevToken->lexeme(text)) ;
     return pr ;
 }
 
@@ -501,7 +665,7 @@ ParseResult Parser::parseIntConst ( ) {
 ParseResult Parser::parseFloatConst ( ) {
     ParseResult pr ;
     match ( floatConst ) ;
-    pr.ast = new AnyConst(prevToken->lexeme);
+    pr.ast = arena.make<AnyConst>(prevToken->lexeme(text));
     return pr ;
 }
 
@@ -512,7 +676,7 @@ ParseResult Parser::parseFloatConst ( ) {
 ParseResult Parser::parseStringConst ( ) {
     ParseResult pr ;
     match ( stringConst ) ;
-    pr.ast = new AnyConst(prevToken->lexeme);
+    pr.ast = arena.make<AnyConst>(prevToken->lexeme(text));
     return pr ;
 }
 
@@ -529,26 +693,26 @@ ParseResult Parser::parseVariableName ( ) {
     Expr *ex1, *ex2;
 
     match ( variableName ) ;
-    VarName* varName = new VarName(prevToken->lexeme);
+    VarName* varName = arena.make<VarName>(prevToken->lexeme(text));
     if(attemptMatch(leftSquare)){
         ParseResult exPr1 = parseExpr(0);
         match(comma);
         ParseResult exPr2 = parseExpr(0);
         match(rightSquare);
         if (exPr1.ast && exPr2.ast) {
-            ex1 = dynamic_cast<Expr *>(exPr1.ast);
-            ex2 = dynamic_cast<Expr *>(exPr2.ast);
+            ex1 = exPr1.expr();
+            ex2 = exPr2.expr();
         }
-        pr.ast = new MatrixRefExpr(varName, ex1, ex2);
+        pr.ast = arena.make<MatrixRefExpr>(varName, ex1, ex2);
     }
     //Expr ::= varableName '(' Expr ')'        //NestedOrFunctionCall
     else if(attemptMatch(leftParen)){
         ParseResult exPr = parseExpr(0);
         match(rightParen);
         if (exPr.ast) {
-            ex1 = dynamic_cast<Expr *>(exPr.ast);
+            ex1 = exPr.expr();
         }
-        pr.ast = new FunctionCall(varName, ex1);
+        pr.ast = arena.make<FunctionCall>(varName, ex1);
     }
     //Expr := variableName
     else{
@@ -574,9 +738,9 @@ ParseResult Parser::parseNestedExpr ( ) {
     ParseResult exPr = parseExpr(0) ; 
     match(rightParen) ;
     if (exPr.ast) {
-        ex = dynamic_cast<Expr *>(exPr.ast);
+        ex = exPr.expr();
     }
-    pr.ast = new ParensExpr(ex);
+    pr.ast = arena.make<ParensExpr>(ex);
     return pr ;
 }
 
@@ -595,12 +759,12 @@ ParseResult Parser::parseIfExpr(){
     match(elseKwd);
     ParseResult exPr3 = parseExpr(0);
     if (exPr1.ast && exPr2.ast && exPr3.ast) {
-        ex1 = dynamic_cast<Expr *>(exPr1.ast);
-        ex2 = dynamic_cast<Expr *>(exPr2.ast);
-        ex3 = dynamic_cast<Expr *>(exPr3.ast);
+        ex1 = exPr1.expr();
+        ex2 = exPr2.expr();
+        ex3 = exPr3.expr();
     }
 
-    pr.ast = new IfExpr(ex1, ex2, ex3);
+    pr.ast = arena.make<IfExpr>(ex1, ex2, ex3);
     return pr;
 }
 
@@ -620,11 +784,11 @@ ParseResult Parser::parseLetExpr(){
     ParseResult exPr = parseExpr(0);
     match(endKwd);
     if (stmtsPr.ast && exPr.ast) {
-        stmts = dynamic_cast<Stmts *>(stmtsPr.ast);
-        ex = dynamic_cast<Expr *>(exPr.ast);
+        stmts = stmtsPr.stmts();
+        ex = exPr.expr();
     }
 
-    pr.ast = new LetExpr(stmts, ex);
+    pr.ast = arena.make<LetExpr>(stmts, ex);
     return pr;
 }
 
@@ -639,10 +803,10 @@ ParseResult Parser::parseNotExpr () {
     match ( notOp ) ;
     ParseResult exPr = parseExpr( 0 ); 
     if (exPr.ast) {
-        ex = dynamic_cast<Expr *>(exPr.ast);
+        ex = exPr.expr();
     }
 
-    pr.ast = new NotExpr(ex);
+    pr.ast = arena.make<NotExpr>(ex);
     return pr ;
 
 }
@@ -653,13 +817,13 @@ ParseResult Parser::parseNotExpr () {
 */ 
 ParseResult Parser::parseAddition ( ParseResult prLeft ) {
     // parser has already matched left expression 
-    Expr* left = dynamic_cast<Expr *>(prLeft.ast);
+    Expr* left = prLeft.expr();
     ParseResult pr ;
     match ( plusSign ) ;
-    string op = prevToken->lexeme;
-    ParseResult exPr = parseExpr( prevToken->lbp() ); 
-    Expr* right = dynamic_cast<Expr *>(exPr.ast);
-    pr.ast = new BinOpExpr(left, op, right);
+    string op = prevToken->lexeme(text);
+    ParseResult exPr = parseExpr( lbp(prevToken->terminal) ); 
+    Expr* right = exPr.expr();
+    pr.ast = arena.make<BinOpExpr>(left, op, right);
     return pr ;
 }
 
@@ -669,13 +833,13 @@ ParseResult Parser::parseAddition ( ParseResult prLeft ) {
 */ 
 ParseResult Parser::parseMultiplication ( ParseResult prLeft ) {
     // parser has already matched left expression 
-    Expr* left = dynamic_cast<Expr *>(prLeft.ast);
+    Expr* left = prLeft.expr();
     ParseResult pr ;
     match ( star ) ;
-    string op = prevToken->lexeme;
-    ParseResult exPr = parseExpr( prevToken->lbp() ); 
-    Expr* right = dynamic_cast<Expr *>(exPr.ast);
-    pr.ast = new BinOpExpr(left, op, right);
+    string op = prevToken->lexeme(text);
+    ParseResult exPr = parseExpr( lbp(prevToken->terminal) ); 
+    Expr* right = exPr.expr();
+    pr.ast = arena.make<BinOpExpr>(left, op, right);
     return pr ;
 }
 
@@ -685,13 +849,13 @@ ParseResult Parser::parseMultiplication ( ParseResult prLeft ) {
 */ 
 ParseResult Parser::parseSubtraction ( ParseResult prLeft ) {
     // parser has already matched left expression 
-    Expr* left = dynamic_cast<Expr *>(prLeft.ast);
+    Expr* left = prLeft.expr();
     ParseResult pr ;
     match ( dash ) ;
-    string op = prevToken->lexeme;
-    ParseResult exPr = parseExpr( prevToken->lbp() ); 
-    Expr* right = dynamic_cast<Expr *>(exPr.ast);
-    pr.ast = new BinOpExpr(left, op, right);
+    string op = prevToken->lexeme(text);
+    ParseResult exPr = parseExpr( lbp(prevToken->terminal) ); 
+    Expr* right = exPr.expr();
+    pr.ast = arena.make<BinOpExpr>(left, op, right);
     return pr ;
 }
 
@@ -701,13 +865,13 @@ ParseResult Parser::parseSubtraction ( ParseResult prLeft ) {
 */ 
 ParseResult Parser::parseDivision ( ParseResult prLeft ) {
     // parser has already matched left expression 
-    Expr* left = dynamic_cast<Expr *>(prLeft.ast);
+    Expr* left = prLeft.expr();
     ParseResult pr ;
     match ( forwardSlash ) ;
-    string op = prevToken->lexeme;
-    ParseResult exPr = parseExpr( prevToken->lbp() ); 
-    Expr* right = dynamic_cast<Expr *>(exPr.ast);
-    pr.ast = new BinOpExpr(left, op, right);
+    string op = prevToken->lexeme(text);
+    ParseResult exPr = parseExpr( lbp(prevToken->terminal) ); 
+    Expr* right = exPr.expr();
+    pr.ast = arena.make<BinOpExpr>(left, op, right);
     return pr ;
 }
 
@@ -737,14 +901,14 @@ ParseResult Parser::parseRelationalExpr ( ParseResult prLeft ) {
     // parser has already matched left expression 
     ParseResult pr ;
 
-    Expr* left = dynamic_cast<Expr *>(prLeft.ast);
+    Expr* left = prLeft.expr();
     nextToken( ) ;
     // just advance token, since examining it in parseExpr caused
     // this method being called.
-    string op = prevToken->lexeme ;
-    ParseResult exPr = parseExpr( prevToken->lbp() ); 
-    Expr* right = dynamic_cast<Expr *>(exPr.ast);
-    pr.ast = new BinOpExpr(left, op, right);
+    string op = prevToken->lexeme(text) ;
+    ParseResult exPr = parseExpr( lbp(prevToken->terminal) ); 
+    Expr* right = exPr.expr();
+    pr.ast = arena.make<BinOpExpr>(left, op, right);
     return pr ;
 }
 
@@ -791,7 +955,7 @@ bool Parser::nextIs (tokenType tt) {
     return currToken->terminal == tt ;
 }
 
-/*! \brief Moves to next token in linked-list 
+/*! \brief Moves to next token in the token array
 
     Used to explicitly move to the next token
     without checking anything.
@@ -802,28 +966,89 @@ void Parser::nextToken () {
     if ( currToken == NULL ) 
         throw ( string("Internal Error: should not call nextToken in unitialized state"));
     else 
-    if (currToken->terminal == endOfFile && currToken->next == NULL) {
+    if (currToken->terminal == endOfFile) {
         prevToken = currToken ;
-    } else if (currToken->terminal != endOfFile && currToken->next == NULL) {
-        throw ( makeErrorMsg ( "Error: tokens end with endOfFile" ) ) ;
     } else {
+        fillWindow (1) ;
         prevToken = currToken ;
-        currToken = currToken->next ;
+        currToken ++ ;
     }
 }
 
+/*! \brief Makes sure [n] tokens past the current one are available
+
+    Only does work when streaming, since otherwise the array already
+    ends with endOfFile.  When the window is full, the tokens before
+    prevToken are dropped from it first.
+
+    @param n Number of tokens of lookahead needed
+    @return void
+*/ 
+void Parser::fillWindow (size_t n) {
+    size_t curr = currToken - &tokens[0] ;
+    if (curr + n < tokens.size() || tokens.back().terminal == endOfFile)
+        return ;
+
+    if (tokens.size() + n > streamWindow && curr > 0) {
+        size_t drop = curr - 1 ;
+        tokens.erase (tokens.begin(), tokens.begin() + drop) ;
+        windowBase += drop ;
+        curr -= drop ;
+    }
+    while ((tokens.size() < streamWindow || tokens.size() <= curr + n)
+           && tokens.back().terminal != endOfFile) {
+        tokens.push_back (s->scanNext (text, &scanOffset)) ;
+    }
+
+    // The array may have moved.
+    currToken = &tokens[curr] ;
+    prevToken = curr > 0 ? &tokens[curr-1] : NULL ;
+}
+
+/*! \brief Looks ahead in the token array
+
+    @param k Number of tokens past the current one; peek(0) is the
+    current token.  Lookahead past the end gives the endOfFile token.
+    @return const TokenSpan&
+*/ 
+const TokenSpan &Parser::peek (int k) {
+    fillWindow (k) ;
+    size_t i = (currToken - &tokens[0]) + k ;
+    if (i >= tokens.size())
+        i = tokens.size() - 1 ;
+    return tokens[i] ;
+}
+
+/*! \brief Returns the position of the current token, for rewind
+
+    @return size_t
+*/ 
+size_t Parser::mark () const {
+    return windowBase + (currToken - &tokens[0]) ;
+}
+
+/*! \brief Backtracks to a position returned by mark
+
+    @param position Index of the token to make current
+    @return void
+*/ 
+void Parser::rewind (size_t position) {
+    if (position < windowBase || position >= windowBase + tokens.size())
+        throw ( string("Internal Error: rewind to a token outside the window") ) ;
+    position -= windowBase ;
+    currToken = &tokens[position] ;
+    prevToken = position > 0 ? &tokens[position-1] : NULL ;
+}
+
 /*! \brief Retrieves the description for a tokenType
 
+    The descriptions are a static table from tokenList.h.
+
     @param terminal tokenType of which we want to know the description
-    @return string 
+    @return const char *
 */ 
-string Parser::terminalDescription ( tokenType terminal ) {
-    Token *dummyToken = new Token ("",terminal, NULL) ;
-    ExtToken *dummyExtToken = extendToken (this, dummyToken) ;
-    string s = dummyExtToken->description() ;
-    delete dummyToken ;
-    delete dummyExtToken ;
-    return s ;
+const char *Parser::terminalDescription ( tokenType terminal ) {
+    return terminalDescriptions[terminal] ;
 }
 
 /*! \brief Creates an expected error message
@@ -836,9 +1061,13 @@ string Parser::terminalDescription ( tokenType terminal ) {
     @return string 
 */ 
 string Parser::makeErrorMsgExpected ( tokenType terminal ) {
-    string s = (string) "Expected " + terminalDescription (terminal) +
-        " but found " + currToken->description() ;
-    return s ;
+    int line, column ;
+    lines.position (currToken->offset, &line, &column) ;
+    char buffer[128] ;
+    snprintf (buffer, sizeof(buffer), "Expected %s but found %s at line %d, column %d",
+              terminalDescription (terminal), terminalDescription (currToken->terminal),
+              line, column) ;
+    return buffer ;
 }
 
 /*! \brief Makes error message based on tokenType
@@ -850,8 +1079,28 @@ string Parser::makeErrorMsgExpected ( tokenType terminal ) {
     @return string 
 */ 
 string Parser::makeErrorMsg ( tokenType terminal ) {
-    string s = "Unexpected symbol " + terminalDescription (terminal) ;
-    return s ;
+    int line, column ;
+    lines.position (currToken->offset, &line, &column) ;
+    char buffer[96] ;
+    snprintf (buffer, sizeof(buffer), "Unexpected symbol %s at line %d, column %d",
+              terminalDescription (terminal), line, column) ;
+    return buffer ;
+}
+
+/*! \brief Describes where a token is in the text
+
+    The line index is only built when the first error message
+    needs it.
+
+    @param t Token to locate
+    @return string of the form "line 3, column 7"
+*/ 
+string Parser::location ( const TokenSpan *t ) {
+    int line, column ;
+    lines.position (t->offset, &line, &column) ;
+    char buffer[64] ;
+    snprintf (buffer, sizeof(buffer), "line %d, column %d", line, column) ;
+    return buffer ;
 }
 
 /*! \brief Makes programmer-defined error message
@@ -26,18 +26,32 @@
 
 #include "scanner.h"
 #include "parseResult.h"
+#include "lineIndex.h"
+#include "arena.h"
 
 #include <string>
+#include <vector>
 
 class ExtToken ;
 
+/* The parser can find the nud, led and lbp of a token in two ways.
+   With virtualDispatch it calls the virtual methods of the token's
+   ExtToken.  With tableDispatch it looks them up in static tables
+   indexed by tokenType, built at compile time in parser.cpp.  Both
+   give the same precedence and call the same parse methods.
+ */
+enum prattDispatchEnumType { virtualDispatch, tableDispatch } ;
+typedef enum prattDispatchEnumType prattDispatchType ;
+
 class Parser {
 
 public:
-    Parser() ;
+    Parser(prattDispatchType d = tableDispatch) ;
     ~Parser() ;
 
     ParseResult parse (const char *text) ;
+    ParseResult parseStream (const char *text) ;
+    void reset () ;
     // Parser methods for the nonterminals:
 
     ParseResult parseProgram () ;
@@ -72,17 +86,64 @@ public:
     bool nextIs (tokenType tt) ;
     void nextToken () ;
 
-    std::string terminalDescription ( tokenType terminal ) ;
+    // Lookahead and rewind over the token array.
+    const TokenSpan &peek (int k) ;
+    size_t mark () const ;
+    void rewind (size_t position) ;
+    void fillWindow (size_t n) ;
+    ExtToken *extToken (const TokenSpan *t) const { return extTokens[t->terminal] ; }
+    int lbp (tokenType tt) ;
+
+    const char *terminalDescription ( tokenType terminal ) ;
     std::string makeErrorMsg ( tokenType terminal ) ;
     std::string makeErrorMsgExpected ( tokenType terminal ) ;
     std::string makeErrorMsg ( const char *msg ) ;
+    std::string location ( const TokenSpan *t ) ;
+
+    // The text being parsed and its tokens, which refer into [text].
+    // After parse, [tokens] holds every token, ending with endOfFile.
+    // After parseStream, it is a window of at most [streamWindow]
+    // tokens that starts with token number [windowBase]; more are
+    // scanned from [scanOffset] as the parser needs them.
+    const char *text ;
+    std::vector<TokenSpan> tokens ;
+    size_t windowBase ;
+    int scanOffset ;
+    static const size_t streamWindow = 16 ;
+
+    // How deeply expressions and statements may nest.  A deeper text
+    // is reported as an error rather than overflowing the stack.  A
+    // level takes about half a KB of stack in an unoptimized build, so
+    // the default needs about 1 MB.
+    int maxDepth ;
+    int depth ;
+    static const int defaultMaxDepth = 2000 ;
+    void enterNested () ;
+
+    // With [recover] set, a syntax error in a statement is recorded in
+    // [diagnostics], the parser skips past the next ';' or to the next
+    // '}', and parsing goes on, so one parse reports every error.
+    bool recover ;
+    std::vector<std::string> diagnostics ;
+
+    // Line starts of [text], for error messages.
+    LineIndex lines ;
+    const TokenSpan *currToken ;
+    const TokenSpan *prevToken ;
+
+    // The nud, led, lbp and description of each terminal.
+    ExtToken *extTokens[lexicalError+1] ;
+    prattDispatchType dispatch ;
 
-    ExtToken *tokens ;
-    ExtToken *currToken ;
-    ExtToken *prevToken ;
-
-    Token *stokens ;
     Scanner *s ;
+
+    // The AST nodes of the latest parse.  A ParseResult's ast is valid
+    // until the next parse or reset of its Parser.
+    Arena arena ;
+
+private:
+    ParseResult parseText (const char *text, bool streaming) ;
+    void resync (const std::string &errMsg) ;
 } ;
 
 #endif /* PARSER_H */
@@ -7,6 +7,7 @@
 #include "parseResult.h"
 
 #include <sstream>
+#include <ctime>
 
 using namespace std ;
 
@@ -90,4 +91,274 @@ public:
         msg += "\n" + pr.errors ; 
         TSM_ASSERT ( msg , pr.ok );
     }
+
+    // After a parse the tokens stay in the parser's token array.
+    void test_parse_peek_rewind ( ) {
+        ParseResult pr = p->parse ( "main () { x = 1 ; }" ) ;
+        TS_ASSERT ( pr.ok ) ;
+        p->rewind ( 0 ) ;
+        TS_ASSERT_EQUALS ( p->currToken->terminal, variableName ) ;
+        TS_ASSERT_EQUALS ( p->peek(3).terminal, leftCurly ) ;
+        TS_ASSERT_EQUALS ( p->peek(100).terminal, endOfFile ) ;
+        size_t m = p->mark() ;
+        p->nextToken () ;
+        p->nextToken () ;
+        TS_ASSERT_EQUALS ( p->currToken->terminal, rightParen ) ;
+        p->rewind ( m ) ;
+        TS_ASSERT_EQUALS ( p->currToken->terminal, variableName ) ;
+    }
+
+    // Both dispatch modes must agree on every binding power.
+    void test_dispatch_modes_same_lbp ( ) {
+        Parser virtualParser (virtualDispatch) ;
+        Parser tableParser (tableDispatch) ;
+        for (int t = 0; t <= lexicalError; t ++) {
+            TS_ASSERT_EQUALS ( tableParser.lbp ((tokenType) t),
+                               virtualParser.lbp ((tokenType) t) ) ;
+        }
+    }
+
+    // Both dispatch modes must build the same tree, and fail alike.
+    void sameParseBothModes ( const char *text ) {
+        Parser virtualParser (virtualDispatch) ;
+        Parser tableParser (tableDispatch) ;
+        ParseResult expected = virtualParser.parse ( text ) ;
+        ParseResult actual = tableParser.parse ( text ) ;
+        TS_ASSERT_EQUALS ( actual.ok, expected.ok ) ;
+        TS_ASSERT_EQUALS ( actual.errors, expected.errors ) ;
+        if (actual.ok && expected.ok) {
+            TS_ASSERT_EQUALS ( actual.ast->unparse(), expected.ast->unparse() ) ;
+        }
+    }
+
+    void test_dispatch_modes_agree ( ) {
+        sameParseBothModes ( "main () { x = 1 + 2 * 3 - 4 / 5 < 6 + 7 ; }" ) ;
+        sameParseBothModes ( "main () { x = ! (a == b) ; y = let z = 1 ; in z + 1 end ; }" ) ;
+        sameParseBothModes ( "main () { x = 1 + ; }" ) ;
+        sameParseBothModes ( "main () { x = 1 ( 2 ) ; }" ) ;
+        const char *files[] = { "../samples/sample_1.dsl", "../samples/sample_2.dsl",
+                                "../samples/sample_3.dsl", "../samples/sample_4.dsl",
+                                "../samples/sample_5.dsl", "../samples/forest_loss_v2.dsl",
+                                "../samples/bad_syntax_good_tokens.dsl" } ;
+        for (int i = 0; i < 7; i ++) {
+            const char *text = readInputFromFile ( files[i] ) ;
+            TS_ASSERT ( text ) ;
+            sameParseBothModes ( text ) ;
+        }
+    }
+
+    // Streaming must build the same tree, and fail alike, as parse.
+    void sameParseStreaming ( const char *text ) {
+        Parser streamParser ;
+        ParseResult expected = p->parse ( text ) ;
+        ParseResult actual = streamParser.parseStream ( text ) ;
+        TS_ASSERT_EQUALS ( actual.ok, expected.ok ) ;
+        TS_ASSERT_EQUALS ( actual.errors, expected.errors ) ;
+        if (actual.ok && expected.ok) {
+            TS_ASSERT_EQUALS ( actual.ast->unparse(), expected.ast->unparse() ) ;
+        }
+        TS_ASSERT ( streamParser.tokens.size() <= Parser::streamWindow ) ;
+    }
+
+    void test_parseStream_agrees ( ) {
+        sameParseStreaming ( "main () { x = 1 + 2 * 3 - 4 / 5 < 6 + 7 ; }" ) ;
+        sameParseStreaming ( "main () { x = 1 + ; }" ) ;
+        sameParseStreaming ( "" ) ;
+        const char *files[] = { "../samples/sample_1.dsl", "../samples/sample_2.dsl",
+                                "../samples/sample_3.dsl", "../samples/sample_4.dsl",
+                                "../samples/sample_5.dsl", "../samples/forest_loss_v2.dsl",
+                                "../samples/bad_syntax_good_tokens.dsl" } ;
+        for (int i = 0; i < 7; i ++) {
+            const char *text = readInputFromFile ( files[i] ) ;
+            TS_ASSERT ( text ) ;
+            sameParseStreaming ( text ) ;
+        }
+    }
+
+    // A syntax error stops scanning within a window of the error.
+    void test_parseStream_stops_at_error ( ) {
+        string text = "main () { x = 1 + ; " ;
+        for (int i = 0; i < 1000; i ++)
+            text += "y = 2 ; " ;
+        text += "}" ;
+        Parser streamParser ;
+        ParseResult pr = streamParser.parseStream ( text.c_str() ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+        TS_ASSERT ( streamParser.scanOffset < 100 ) ;
+    }
+
+    // Error messages give the line and column of the offending token.
+    void test_parse_error_location ( ) {
+        ParseResult pr = p->parse ( "main () {\n  x = 1 ;\n  y = 2 + ;\n}" ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+        TS_ASSERT_DIFFERS ( pr.errors.find ( "line 3, column 11" ), string::npos ) ;
+        pr = p->parse ( "main ( {\n}" ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+        TS_ASSERT_DIFFERS ( pr.errors.find ( "line 1, column 8" ), string::npos ) ;
+    }
+
+    // A reused Parser frees each tree and holds no more memory than
+    // its largest text needed.
+    void test_parser_reuse ( ) {
+        const char *text = readInputFromFile ( "../samples/sample_5.dsl" ) ;
+        TS_ASSERT ( text ) ;
+        Parser reused ;
+        ParseResult pr = reused.parse ( text ) ;
+        TS_ASSERT ( pr.ok ) ;
+        string first = pr.ast->unparse() ;
+        size_t blocks = reused.arena.numBlocks() ;
+        size_t capacity = reused.tokens.capacity() ;
+        for (int i = 0; i < 200; i ++) {
+            reused.parse ( "main () { x = 1 ; }" ) ;
+            pr = reused.parse ( text ) ;
+            TS_ASSERT ( pr.ok ) ;
+        }
+        TS_ASSERT_EQUALS ( pr.ast->unparse(), first ) ;
+        TS_ASSERT_EQUALS ( reused.arena.numBlocks(), blocks ) ;
+        TS_ASSERT_EQUALS ( reused.tokens.capacity(), capacity ) ;
+
+        reused.reset() ;
+        TS_ASSERT ( reused.tokens.empty() ) ;
+        TS_ASSERT_EQUALS ( reused.arena.numObjects(), 0u ) ;
+    }
+
+    // A long statement list is parsed and printed without recursion.
+    void test_parse_long_stmts ( ) {
+        string text = "main () { " ;
+        for (int i = 0; i < 100000; i ++)
+            text += "x = 1 ; " ;
+        text += "}" ;
+        ParseResult pr = p->parse ( text.c_str() ) ;
+        TS_ASSERT ( pr.ok ) ;
+        TS_ASSERT ( pr.ast->unparse().size() > 600000u ) ;
+        TS_ASSERT ( pr.ast->cppCode().size() > 600000u ) ;
+    }
+
+    /* A chain of operators is not nesting: it is parsed, and printed,
+       with loops, however long it is.
+     */
+    void test_parse_long_chain ( ) {
+        string text = "main () { x = a" ;
+        for (int i = 1; i < 1000000; i ++)
+            text += " + a" ;
+        text += " ; }" ;
+        ParseResult pr = p->parse ( text.c_str() ) ;
+        TS_ASSERT ( pr.ok ) ;
+        TS_ASSERT ( pr.ast->cppCode().size() > 4000000u ) ;
+        TS_ASSERT ( pr.ast->unparse().size() > 4000000u ) ;
+    }
+
+    // Nesting past maxDepth is an error, not a stack overflow.
+    string nested ( const char *open, int n, const char *middle, const char *close ) {
+        string text ;
+        for (int i = 0; i < n; i ++)
+            text += open ;
+        text += middle ;
+        for (int i = 0; i < n; i ++)
+            text += close ;
+        return text ;
+    }
+
+    void test_parse_depth_limit ( ) {
+        Parser deep ;
+        string parens = "main () { x = " + nested ("(", 100000, "1", ")") + " ; }" ;
+        ParseResult pr = deep.parse ( parens.c_str() ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+        TS_ASSERT_DIFFERS ( pr.errors.find ( "Nesting deeper than 2000 levels" ), string::npos ) ;
+
+        string blocks = "main () " + nested ("{ ", 100000, "x = 1 ; ", "} ") ;
+        pr = deep.parse ( blocks.c_str() ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+
+        string lets = "main () { x = " + nested ("let y = ", 100000, "1", " ; in y end") + " ; }" ;
+        pr = deep.parse ( lets.c_str() ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+
+        // Within the limit, and after an error, parsing works.
+        parens = "main () { x = " + nested ("(", 1000, "1", ")") + " ; }" ;
+        pr = deep.parse ( parens.c_str() ) ;
+        TS_ASSERT ( pr.ok ) ;
+        deep.maxDepth = 100 ;
+        pr = deep.parse ( parens.c_str() ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+    }
+
+    // With recover set, one parse reports every syntax error.
+    void test_parse_recover ( ) {
+        const char *text = "main () {\n  x = 1 + ;\n  y = 2 ;\n  z = ) ;\n"
+                           "  { w = ( ; v = 3 }\n  print ( y ) ;\n}" ;
+        ParseResult pr = p->parse ( text ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+        TS_ASSERT_EQUALS ( pr.diagnostics.size(), 1u ) ;
+
+        Parser recovering ;
+        recovering.recover = true ;
+        pr = recovering.parse ( text ) ;
+        TS_ASSERT ( ! pr.ok ) ;
+        TS_ASSERT ( pr.ast == NULL ) ;
+        TS_ASSERT_EQUALS ( pr.diagnostics.size(), 4u ) ;
+        if (pr.diagnostics.size() == 4) {
+            TS_ASSERT_DIFFERS ( pr.diagnostics[0].find ( "line 2" ), string::npos ) ;
+            TS_ASSERT_DIFFERS ( pr.diagnostics[1].find ( "line 4" ), string::npos ) ;
+            TS_ASSERT_DIFFERS ( pr.diagnostics[2].find ( "line 5, column 11" ), string::npos ) ;
+            TS_ASSERT_DIFFERS ( pr.diagnostics[3].find ( "line 5, column 19" ), string::npos ) ;
+        }
+        TS_ASSERT_EQUALS ( pr.errors, pr.diagnostics[0] + "\n" + pr.diagnostics[1] + "\n"
+                           + pr.diagnostics[2] + "\n" + pr.diagnostics[3] ) ;
+
+        // An error that runs into the end of the text ends the parse.
+        pr = recovering.parse ( "main () { x = 1 + ; y = " ) ;
+        TS_ASSERT_EQUALS ( pr.diagnostics.size(), 2u ) ;
+        pr = recovering.parseStream ( "main () { x = 1 + ; y = " ) ;
+        TS_ASSERT_EQUALS ( pr.diagnostics.size(), 2u ) ;
+
+        pr = recovering.parse ( "main () { x = 1 ; }" ) ;
+        TS_ASSERT ( pr.ok ) ;
+        TS_ASSERT ( pr.diagnostics.empty() ) ;
+    }
+
+    /* A correct program parses no slower with recover set: the try
+       block around each statement costs nothing until something is
+       thrown.  The best of several interleaved runs is compared, with
+       some slack for a busy machine.
+     */
+    void test_parse_recover_speed ( ) {
+        string text = "main () { Int x ; " ;
+        for (int i = 0; i < 50000; i ++)
+            text += "x = (x + 1) * 2 ; if ( x > 3 ) { x = x - 1 ; } else { } " ;
+        text += "}" ;
+
+        Parser plain, recovering ;
+        recovering.recover = true ;
+        double plainBest = 0, recoverBest = 0 ;
+        for (int run = 0; run < 5; run ++) {
+            clock_t start = clock() ;
+            TS_ASSERT ( plain.parse ( text.c_str() ).ok ) ;
+            double plainTime = double (clock() - start) / CLOCKS_PER_SEC ;
+
+            start = clock() ;
+            TS_ASSERT ( recovering.parse ( text.c_str() ).ok ) ;
+            double recoverTime = double (clock() - start) / CLOCKS_PER_SEC ;
+
+            if (run == 0 || plainTime < plainBest)
+                plainBest = plainTime ;
+            if (run == 0 || recoverTime < recoverBest)
+                recoverBest = recoverTime ;
+        }
+        TS_ASSERT_LESS_THAN_EQUALS ( recoverBest, plainBest * 1.25 + 0.01 ) ;
+    }
+
+    // Descriptions come from one static table shared with the scanner.
+    void test_terminal_descriptions ( ) {
+        for (int t = 0; t <= lexicalError; t ++) {
+            TS_ASSERT ( terminalDescriptions[t] != NULL ) ;
+            TS_ASSERT_EQUALS ( p->extTokens[t]->description(), terminalDescriptions[t] ) ;
+        }
+        TS_ASSERT_EQUALS ( string ( p->terminalDescription (semiColon) ), ";" ) ;
+        TS_ASSERT_EQUALS ( string ( p->terminalDescription (lessThanEqual) ), "<=" ) ;
+        ParseResult pr = p->parse ( "main () { x = 1 }" ) ;
+        TS_ASSERT_EQUALS ( pr.errors, "Expected ; but found } at line 1, column 17" ) ;
+        pr = p->parse ( "main () { x = ; }" ) ;
+        TS_ASSERT_EQUALS ( pr.errors, "Unexpected symbol ; at line 1, column 15" ) ;
+    }
 } ;
@@ -1,14 +1,49 @@
 /* readInput.cpp provides 
     char *readInput (int argc, char **argv) ;
    to return a pointer to a character buffer containing the 
-   contents of a file. 
+   contents of a file, and the SourceBuffer class, which holds the
+   contents of a file without copying them when it can.
 */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>  
 
+#include "readInput.h"
+
+/* Reads all of [in_fp] into a malloc'd buffer with a terminating null
+   char, using [sizeHint] as the first guess of its size.  The length
+   read is stored in [length].
+ */
+static char *readAll (FILE *in_fp, size_t sizeHint, size_t *length) {
+    // +1 for terminating null char, +1 so that a read of exactly
+    // [sizeHint] chars stops short and shows the end was reached.
+    size_t capacity = sizeHint + 2 ;
+    char *buffer = (char *) malloc( sizeof(char) * capacity ) ;
+    size_t index = 0 ;
+
+    while (buffer != NULL) {
+        index += fread (buffer + index, 1, capacity - 1 - index, in_fp) ;
+        if (index < capacity - 1)
+            break ;
+        // The file grew, or its size was not known: read some more.
+        capacity = capacity * 2 + 4096 ;
+        char *bigger = (char *) realloc (buffer, capacity) ;
+        if (bigger == NULL)
+            free (buffer) ;
+        buffer = bigger ;
+    }
+    if (buffer == NULL)
+        return NULL ;
+
+    buffer[index] = '\0' ;
+    *length = index ;
+    return buffer ;
+}
 
 char *readInputFromFile (const char *filename) {
     FILE *in_fp ;
@@ -20,24 +55,84 @@ char *readInputFromFile (const char *filename) {
 
     // Determine the size of the file, used to allocate the char buffer.
     struct stat filestatus;
-    stat( filename, &filestatus );
+    size_t filesize = 0 ;
+    if ( fstat( fileno(in_fp), &filestatus ) == 0 )
+        filesize = filestatus.st_size ;
 
-    int filesize = filestatus.st_size + 1; // +1 for terminating null char
+    size_t length ;
+    char *buffer = readAll (in_fp, filesize, &length) ;
+    fclose (in_fp) ;
+    return buffer ;
+}
 
-    // Allocate space for the character buffer.
-    char *buffer = (char *) malloc( sizeof(char) * filesize ) ;
+SourceBuffer::SourceBuffer () 
+    : data(NULL), length(0), mappedLength(0) { }
 
-    int index = 0 ;
-    char ch = getc(in_fp) ;
+SourceBuffer::SourceBuffer (const char *filename) 
+    : data(NULL), length(0), mappedLength(0) {
+    open (filename) ;
+}
 
-    while (ch != EOF) {
-        buffer[index] = ch ;
-        index ++ ; 
-        ch = getc(in_fp);
+SourceBuffer::~SourceBuffer () {
+    close () ;
+}
+
+/* Opens [filename], closing any file that was open before.  Returns
+   false if the file cannot be read.
+ */
+bool SourceBuffer::open (const char *filename) {
+    close () ;
+
+    int fd = ::open (filename, O_RDONLY) ;
+    if (fd < 0)
+        return false ;
+
+    struct stat filestatus ;
+    bool regular = fstat (fd, &filestatus) == 0 && S_ISREG(filestatus.st_mode) ;
+    if (regular) {
+        /* Reserve at least one page more than the file needs, then map
+           the file over the start of it.  The bytes after the end of
+           the file, up to the end of the reservation, read as zero and
+           serve as the sentinel.
+         */
+        size_t filesize = filestatus.st_size ;
+        size_t pageSize = sysconf (_SC_PAGESIZE) ;
+        size_t reserved = (filesize / pageSize + 1) * pageSize ;
+        void *base = mmap (NULL, reserved, PROT_READ, 
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) ;
+        if (base != MAP_FAILED) {
+            if (filesize == 0 ||
+                mmap (base, filesize, PROT_READ, MAP_PRIVATE | MAP_FIXED, 
+                      fd, 0) != MAP_FAILED) {
+                ::close (fd) ;
+                data = (char *) base ;
+                length = filesize ;
+                mappedLength = reserved ;
+                return true ;
+            }
+            munmap (base, reserved) ;
+        }
     }
-    buffer[index] = '\0' ;
 
-    return buffer ;
+    // Not a regular file, or mapping failed: read it instead.
+    FILE *in_fp = fdopen (fd, "r") ;
+    if (in_fp == NULL) {
+        ::close (fd) ;
+        return false ;
+    }
+    data = readAll (in_fp, regular ? filestatus.st_size : 0, &length) ;
+    fclose (in_fp) ;
+    return data != NULL ;
+}
+
+void SourceBuffer::close () {
+    if (mappedLength > 0)
+        munmap (data, mappedLength) ;
+    else
+        free (data) ;
+    data = NULL ;
+    length = 0 ;
+    mappedLength = 0 ;
 }
 
 
@@ -1,8 +1,39 @@
 #ifndef READINPUT_H
 #define READINPUT_H
 
+#include <stddef.h>
+
 char *readInput (int argc, char **argv) ;
 
 char *readInputFromFile (const char *filename) ;
 
+/* A SourceBuffer holds the contents of a file, followed by a '\0'
+   sentinel, for as long as the SourceBuffer exists.  The file is
+   memory-mapped when possible, so the scanner works directly on the
+   mapped pages without a copy; otherwise it is read into a heap
+   buffer with a single bulk read.
+ */
+class SourceBuffer {
+public:
+    SourceBuffer () ;
+    SourceBuffer (const char *filename) ;
+    ~SourceBuffer () ;
+
+    bool open (const char *filename) ;
+    void close () ;
+
+    // The text of the file, or NULL if no file is open.
+    const char *text () const { return data ; }
+    size_t size () const { return length ; }
+    bool isMapped () const { return mappedLength > 0 ; }
+
+private:
+    SourceBuffer (const SourceBuffer &) ;
+    SourceBuffer &operator= (const SourceBuffer &) ;
+
+    char *data ;
+    size_t length ;
+    size_t mappedLength ;
+} ;
+
 #endif /* READINPUT_H */
@@ -35,7 +35,7 @@ regex_t * makeRegex (const char* pattern) {
 }
 
 
-int matchRegex (regex_t *re, const char *text) {
+int matchRegex (const regex_t *re, const char *text) {
     int status ;
     const int nsub=1 ;
     regmatch_t matches[nsub] ;
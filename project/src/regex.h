@@ -11,6 +11,6 @@
 
 regex_t *makeRegex (const char* pattern) ;
 
-int matchRegex (regex_t *, const char *) ;
+int matchRegex (const regex_t *, const char *) ;
 
 #endif /* REGEX_H */
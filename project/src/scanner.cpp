@@ -1,16 +1,171 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
 #include <iostream>
+#include <algorithm>
+#include <thread>
 
 #include <regex.h>
 #include <sys/stat.h>
 #include <sys/types.h>  
 #include "regex.h"
+#include "dfa.h"
+#include "skipper.h"
 #include "scanner.h"
 
 using namespace std;
 
+/* The regular expression for each tokenType, indexed by tokenType,
+   from tokenList.h.  These are used by both scanner engines.
+ */
+static const char *tokenPatterns[lexicalError+1] = {
+#define TOKEN_PATTERN(name, pattern, description) pattern,
+	TOKEN_LIST(TOKEN_PATTERN)
+#undef TOKEN_PATTERN
+} ;
+
+const char *const terminalDescriptions[lexicalError+1] = {
+#define TOKEN_DESCRIPTION(name, pattern, description) description,
+	TOKEN_LIST(TOKEN_DESCRIPTION)
+#undef TOKEN_DESCRIPTION
+} ;
+
+/* White space, block comments and single-line comments, used by the
+   regexEngine.  The dfaEngine uses skipWhiteSpaceAndComments from
+   skipper.h, which accepts the same text.
+ */
+static const char *skipPatterns[] = {
+	"^[\n\t\r ]+",
+	"^/\\*([^\\*]|\\*+[^\\*/])*\\*+/",
+	"^//[^\n]*\n"
+} ;
+
+/* The dfaEngine scans identifiers itself and then looks them up in a
+   perfect hash table of the keywords, built at compile time.  An
+   identifier is a keyword only if it is exactly that keyword, so
+   "in" is inKwd but "interval" and "Int_" are variableNames, just as
+   with the longest-match rule.
+ */
+class Keyword {
+	public:
+		const char *text ;
+		int length ;
+		tokenType terminal ;
+} ;
+
+static constexpr Keyword keywords[] = {
+	{ "Int", 3, intKwd },		{ "Float", 5, floatKwd },	{ "Bool", 4, boolKwd },
+	{ "True", 4, trueKwd },		{ "False", 5, falseKwd },	{ "Str", 3, stringKwd },
+	{ "Matrix", 6, matrixKwd },	{ "let", 3, letKwd },		{ "in", 2, inKwd },
+	{ "end", 3, endKwd },		{ "if", 2, ifKwd },			{ "then", 4, thenKwd },
+	{ "else", 4, elseKwd },		{ "for", 3, forKwd },		{ "while", 5, whileKwd },
+	{ "print", 5, printKwd }
+} ;
+static const int numKeywords = sizeof(keywords) / sizeof(keywords[0]) ;
+static_assert (numKeywords == printKwd - intKwd + 1, "every keyword is in the table") ;
+
+// The hash uses the first and last characters and the length, which
+// differ for every pair of keywords.
+static constexpr uint32_t keywordKey (const char *text, int length) {
+	return (unsigned char) text[0] | (unsigned char) text[length-1] << 8 | length << 16 ;
+}
+
+static const int keywordSlotBits = 5 ;
+static constexpr int keywordSlot (uint32_t seed, uint32_t key) {
+	return (uint32_t) (key * seed) >> (32 - keywordSlotBits) ;
+}
+
+class KeywordTable {
+	public:
+		uint32_t seed ;
+		int slot[1 << keywordSlotBits] ;	// index into keywords, or -1
+} ;
+
+// Tries multipliers, starting from the golden ratio multiplier of
+// Fibonacci hashing, until one sends each keyword to its own slot.
+static constexpr KeywordTable makeKeywordTable () {
+	for (uint32_t seed = 0x9E3779B1u; ; seed += 2) {
+		KeywordTable t = { seed, { } } ;
+		for (int i = 0; i < (1 << keywordSlotBits); i++)
+			t.slot[i] = -1 ;
+		bool perfect = true ;
+		for (int k = 0; k < numKeywords && perfect; k++) {
+			int i = keywordSlot(seed, keywordKey(keywords[k].text, keywords[k].length)) ;
+			perfect = t.slot[i] == -1 ;
+			t.slot[i] = k ;
+		}
+		if (perfect)
+			return t ;
+	}
+}
+
+static constexpr KeywordTable keywordTable = makeKeywordTable() ;
+
+class IdentifierChars {
+	public:
+		bool start[256] ;
+		bool rest[256] ;
+} ;
+
+static constexpr IdentifierChars makeIdentifierChars () {
+	IdentifierChars c = { { }, { } } ;
+	for (int ch = 0; ch < 256; ch++) {
+		c.start[ch] = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_' ;
+		c.rest[ch] = c.start[ch] || (ch >= '0' && ch <= '9') ;
+	}
+	return c ;
+}
+
+static constexpr IdentifierChars identifierChars = makeIdentifierChars() ;
+
+// The keyword spelled by the identifier [text] of [length], or variableName.
+static tokenType keywordOrVariableName (const char *text, int length) {
+	int k = keywordTable.slot[keywordSlot(keywordTable.seed, keywordKey(text, length))] ;
+	if (k >= 0 && keywords[k].length == length &&
+		memcmp(keywords[k].text, text, length) == 0)
+		return keywords[k].terminal ;
+	return variableName ;
+}
+
+ScannerTables::ScannerTables (scannerEngineType e) {
+	for (int i=intKwd; i != lexicalError + 1; i++) {
+		regexes[i] = NULL ;
+	}
+	whiteSpace = blockComment = lineComment = NULL ;
+	tokenDFA = NULL ;
+
+	if (e == dfaEngine) {
+		tokenDFA = makeDFA(tokenPatterns, lexicalError + 1) ;
+	} else {
+		for (int i=intKwd; i != lexicalError + 1; i++) {
+			regexes[i] = makeRegex(tokenPatterns[i]) ;
+		}
+		whiteSpace = makeRegex (skipPatterns[0]) ;
+		blockComment = makeRegex (skipPatterns[1]) ;
+		lineComment = makeRegex (skipPatterns[2]) ;
+	}
+}
+
+/* Function-local statics are initialized exactly once, even when
+   several threads get here at the same time.
+ */
+const ScannerTables &ScannerTables::get (scannerEngineType e) {
+	if (e == dfaEngine) {
+		static const ScannerTables dfaTables(dfaEngine) ;
+		return dfaTables ;
+	}
+	static const ScannerTables regexTables(regexEngine) ;
+	return regexTables ;
+}
+
+Scanner::Scanner (scannerEngineType e) {
+	engine = e ;
+	tables = &ScannerTables::get(e) ;
+}
+
 Token::Token (string _lexeme, tokenType _terminal, Token *_next) {
 	lexeme = _lexeme;
 	terminal = _terminal;
@@ -18,24 +173,53 @@ Token::Token (string _lexeme, tokenType _terminal, Token *_next) {
 }
 
 Token * Scanner::matchNextToken(const char *text) {
-	int maxNumMatchedChars = 0, numMatchedChars = 0, token_holder;
-	tokenType token_value;
-	string lexeme = "";
+	TokenSpan span = matchNextSpan(text) ;
+	return new Token(span.lexeme(text), span.terminal, NULL) ;
+}
+
+/* Matches the token at the start of [text].  The returned span has
+   offset 0; scanSpans places it in the full text.  If [examined] is
+   not NULL, the number of characters looked at to find the token is
+   stored there; the regexEngine cannot tell, so it stores INT_MAX.
+ */
+TokenSpan Scanner::matchNextSpan(const char *text, int *examined) {
+	if (engine == dfaEngine) {
+		if (identifierChars.start[(unsigned char) text[0]]) {
+			int length = 1 ;
+			while (identifierChars.rest[(unsigned char) text[length]])
+				length++ ;
+			if (examined != NULL)
+				*examined = length + 1 ;
+			return TokenSpan(0, length, keywordOrVariableName(text, length)) ;
+		}
+
+		int token_holder ;
+		int numMatchedChars = matchDFA(tables->tokenDFA, text, &token_holder, examined) ;
+		if (numMatchedChars == 0) {
+			// Not reachable with the patterns above, since lexicalError
+			// matches any character; guarantees the scanner makes progress.
+			numMatchedChars = 1 ;
+			token_holder = lexicalError ;
+		}
+		return TokenSpan(0, numMatchedChars, static_cast<tokenType>(token_holder)) ;
+	}
+
+	if (examined != NULL)
+		*examined = INT_MAX ;
+	int maxNumMatchedChars = 0, numMatchedChars = 0, token_holder = lexicalError;
 	for (int i=intKwd; i != lexicalError + 1; i++){
-		numMatchedChars = matchRegex(regexes[i], text);
+		numMatchedChars = matchRegex(tables->regexes[i], text);
 		if (numMatchedChars > maxNumMatchedChars) {
 			maxNumMatchedChars = numMatchedChars;
 			token_holder = i;
-			lexeme.assign(text, numMatchedChars);
 		}
 	}
-	token_value = static_cast<tokenType>(token_holder);
-	return new Token(lexeme, token_value, NULL) ;
+	return TokenSpan(0, maxNumMatchedChars, static_cast<tokenType>(token_holder)) ;
 }
 
-int Scanner::consumeWhiteSpaceAndComments (regex_t *whiteSpace, 
-                                  regex_t *blockComment, 
-				  				  regex_t *lineComment,
+int Scanner::consumeWhiteSpaceAndComments (const regex_t *whiteSpace, 
+                                  const regex_t *blockComment, 
+				  				  const regex_t *lineComment,
                                   const char *text) {
     int numMatchedChars = 0 ;
     int totalNumMatchedChars = 0 ;
@@ -73,43 +257,285 @@ int Scanner::consumeWhiteSpaceAndComments (regex_t *whiteSpace,
     return totalNumMatchedChars ;
 }
 
-Token * Scanner::scan(const char *text) {
+int Scanner::consumeWhiteSpaceAndComments (const char *text) {
+    if (engine == regexEngine) {
+        return consumeWhiteSpaceAndComments (tables->whiteSpace, tables->blockComment, 
+                                             tables->lineComment, text) ;
+    }
+
+    return skipWhiteSpaceAndComments (text) ;
+}
+
+/* Appends the tokens of [text] to [spans], ending with an endOfFile
+   span of length 0.  No lexemes are copied.
+ */
+void Scanner::scanSpans(const char *text, vector<TokenSpan> &spans) {
+	int offset = 0 ;
+	do {
+		spans.push_back(scanNext(text, &offset)) ;
+	} while (spans.back().terminal != endOfFile) ;
+}
+
+/* Returns the token that follows any whitespace and comments at
+   [*offset] in [text], or the endOfFile span if there is none, and
+   moves [*offset] past it.  Scanning can be resumed from any offset
+   left by an earlier call, so tokens can be pulled one at a time.
 
-	regex_t *whiteSpace ;
-    whiteSpace = makeRegex ("^[\n\t\r ]+") ;
-
-    regex_t *blockComment ;
-    blockComment = makeRegex ("^/\\*([^\\*]|\\*+[^\\*/])*\\*+/") ;
-
-    regex_t *lineComment ;
-    lineComment = makeRegex ("^//[^\n]*\n") ;
-
-    // Removes any initial whitespace or comments
-    // Declares what the first token is so that 
-	// we can later return the front of the linked list
-	Token *startingToken = NULL ;
-	Token *curToken = startingToken ;
-	Token *newestToken = startingToken ;
-	int numMatchedChars = consumeWhiteSpaceAndComments(whiteSpace, blockComment, lineComment, text) ;
-	text = text + numMatchedChars ;
-	while ( text[0] != '\0') {
-		
-		newestToken = matchNextToken(text) ;
-		if (startingToken == NULL) {
-			startingToken = newestToken;
-			curToken = newestToken;
-		} else {
-			curToken->next = newestToken ;
-			curToken = newestToken ;
+   If [examined] is not NULL, it is set to one past the last offset in
+   [text] that was looked at; the result depends on no other part of
+   the text.  The regexEngine cannot tell, so it sets INT_MAX.
+ */
+TokenSpan Scanner::scanNext(const char *text, int *offset, int *examined) {
+	int scanStart = *offset ;
+	int skipExamined = INT_MAX ;
+	if (engine == dfaEngine)
+		*offset += skipWhiteSpaceAndComments(text + *offset, bestSkipper(), &skipExamined) ;
+	else
+		*offset += consumeWhiteSpaceAndComments(text + *offset) ;
+
+	TokenSpan span(*offset, 0, endOfFile) ;
+	int tokenExamined = 0 ;
+	if (text[*offset] != '\0') {
+		span = matchNextSpan(text + *offset, &tokenExamined) ;
+		span.offset = *offset ;
+		*offset += span.length ;
+	}
+
+	if (examined != NULL) {
+		if (skipExamined == INT_MAX || tokenExamined == INT_MAX)
+			*examined = INT_MAX ;
+		else
+			*examined = max(scanStart + skipExamined, span.offset + tokenExamined) ;
+	}
+	return span ;
+}
+
+/* Scans the tokens of [text] on [numThreads] threads (by default, one
+   per core) and appends them to [spans], exactly as scanSpans would.
+
+   The text is split into chunks that start just after a newline, and
+   each chunk is scanned on its own thread as if a token began there.
+   That guess is wrong if the chunk starts inside a string or a block
+   comment, so the chunks are then stitched together in order: the
+   scan that is known to be right is carried on past the end of the
+   previous chunk until it reaches a token that the next chunk's scan
+   also found.  From a token start, scanning is deterministic, so the
+   rest of that chunk's tokens can be taken as they are.  Usually this
+   costs one token per chunk; at worst, a chunk is scanned again.
+ */
+void Scanner::scanSpansParallel(const char *text, vector<TokenSpan> &spans,
+                                int numThreads, int minChunkSize) {
+	int length = strlen(text) ;
+	if (numThreads <= 0)
+		numThreads = max(1, (int) thread::hardware_concurrency()) ;
+	numThreads = min(numThreads, max(1, length / max(1, minChunkSize))) ;
+	if (numThreads == 1) {
+		scanSpans(text, spans) ;
+		return ;
+	}
+
+	vector<int> starts(numThreads + 1) ;
+	starts[0] = 0 ;
+	for (int i = 1; i < numThreads; i++) {
+		int s = max(starts[i-1], (int) ((long long) length * i / numThreads)) ;
+		const char *newline = (const char *) memchr(text + s, '\n', length - s) ;
+		starts[i] = newline ? newline - text + 1 : length ;
+	}
+	starts[numThreads] = length ;
+
+	// Chunk i holds the tokens that start in [starts[i], starts[i+1]).
+	vector< vector<TokenSpan> > chunks(numThreads) ;
+	vector<thread> workers ;
+	for (int i = 0; i < numThreads; i++) {
+		workers.push_back(thread([this, text, i, &starts, &chunks] () {
+			int offset = starts[i] ;
+			while (true) {
+				TokenSpan span = scanNext(text, &offset) ;
+				if (span.terminal == endOfFile || span.offset >= starts[i+1])
+					break ;
+				chunks[i].push_back(span) ;
+			}
+		})) ;
+	}
+	for (int i = 0; i < numThreads; i++)
+		workers[i].join() ;
+
+	// Chunk 0 starts at the start of the text, so it is right as it is.
+	spans.insert(spans.end(), chunks[0].begin(), chunks[0].end()) ;
+	int offset = spans.empty() ? 0 : spans.back().offset + spans.back().length ;
+	for (int i = 1; i < numThreads; i++) {
+		const vector<TokenSpan> &chunk = chunks[i] ;
+		while (true) {
+			int resume = offset ;
+			TokenSpan span = scanNext(text, &offset) ;
+			if (span.terminal == endOfFile || span.offset >= starts[i+1]) {
+				offset = resume ;	// chunk i has no more tokens
+				break ;
+			}
+			spans.push_back(span) ;
+
+			// Look for the same token in chunk i.
+			vector<TokenSpan>::const_iterator same = chunk.end() ;
+			if (! chunk.empty() && span.offset <= chunk.back().offset) {
+				same = lower_bound(chunk.begin(), chunk.end(), span,
+					[] (const TokenSpan &a, const TokenSpan &b) { return a.offset < b.offset ; }) ;
+			}
+			if (same != chunk.end() && same->offset == span.offset) {
+				spans.insert(spans.end(), same + 1, chunk.end()) ;
+				offset = spans.back().offset + spans.back().length ;
+				break ;
+			}
+		}
+	}
+
+	// The tokens, if any, after the last chunk, and the endOfFile token.
+	do {
+		spans.push_back(scanNext(text, &offset)) ;
+	} while (spans.back().terminal != endOfFile) ;
+}
+
+void IncrementalScanner::scan (const char *text) {
+	spans.clear() ;
+	examinedEnds.clear() ;
+	int offset = 0, examined, furthest = 0 ;
+	do {
+		spans.push_back(scanner->scanNext(text, &offset, &examined)) ;
+		furthest = max(furthest, examined) ;
+		examinedEnds.push_back(furthest) ;
+	} while (spans.back().terminal != endOfFile) ;
+	length = strlen(text) ;
+	gapStart = gapEnd = spans.size() ;
+	lastRescanned = spans.size() ;
+}
+
+TokenSpan IncrementalScanner::token (int i) const {
+	if (i < gapStart)
+		return spans[i] ;
+	TokenSpan span = spans[i + gapEnd - gapStart] ;
+	span.offset += length ;
+	return span ;
+}
+
+vector<TokenSpan> IncrementalScanner::tokens () const {
+	vector<TokenSpan> all ;
+	for (int i = 0; i < size(); i++)
+		all.push_back(token(i)) ;
+	return all ;
+}
+
+int IncrementalScanner::examinedEnd (int i) const {
+	if (i < gapStart)
+		return examinedEnds[i] ;
+	int end = examinedEnds[i + gapEnd - gapStart] ;
+	return end == INT_MAX ? end : end + length ;
+}
+
+// Where the scan that found token i started: the end of token i-1.
+int IncrementalScanner::oldStart (int i) const {
+	if (i == 0)
+		return 0 ;
+	TokenSpan span = token(i-1) ;
+	return span.offset + span.length ;
+}
+
+// Moves the gap to just before token [to], changing the offsets of the
+// tokens it passes over from one end of the text to the other.
+void IncrementalScanner::moveGap (int to) {
+	while (gapStart > to) {
+		gapStart -- ;
+		gapEnd -- ;
+		spans[gapEnd] = spans[gapStart] ;
+		spans[gapEnd].offset -= length ;
+		examinedEnds[gapEnd] = examinedEnds[gapStart] == INT_MAX
+			? INT_MAX : examinedEnds[gapStart] - length ;
+	}
+	while (gapStart < to) {
+		spans[gapStart] = spans[gapEnd] ;
+		spans[gapStart].offset += length ;
+		examinedEnds[gapStart] = examinedEnds[gapEnd] == INT_MAX
+			? INT_MAX : examinedEnds[gapEnd] + length ;
+		gapStart ++ ;
+		gapEnd ++ ;
+	}
+}
+
+void IncrementalScanner::edit (const char *text, int offset, int removedLength, int insertedLength) {
+	int delta = insertedLength - removedLength ;
+	int editEnd = offset + removedLength ;	// in the old text
+
+	// The first token whose scan looked at a changed character.
+	int first = 0, last = size() ;
+	while (first < last) {
+		int middle = (first + last) / 2 ;
+		if (examinedEnd(middle) <= offset)
+			first = middle + 1 ;
+		else
+			last = middle ;
+	}
+	int furthest = first > 0 ? examinedEnd(first-1) : 0 ;
+	int scanOffset = oldStart(first) ;
+
+	// Rescan until the scan is where the old one started a token
+	// [resume], past the edit, or until the end of the text.
+	vector<TokenSpan> fresh ;
+	vector<int> freshExamined ;
+	int resume = first ;
+	while (true) {
+		int examined ;
+		TokenSpan span = scanner->scanNext(text, &scanOffset, &examined) ;
+		fresh.push_back(span) ;
+		furthest = max(furthest, examined) ;
+		freshExamined.push_back(furthest) ;
+		if (span.terminal == endOfFile) {
+			resume = size() ;
+			break ;
 		}
-		text = text + curToken->lexeme.length();
-		numMatchedChars = consumeWhiteSpaceAndComments(whiteSpace, blockComment, lineComment, text) ;
-		text = text + numMatchedChars;
+
+		// The old scan started token j at the end of token j-1.
+		while (resume < size() &&
+			   (oldStart(resume) < editEnd || oldStart(resume) + delta < scanOffset))
+			resume ++ ;
+		if (resume < size() && oldStart(resume) + delta == scanOffset)
+			break ;
+	}
+
+	// Replace the old tokens [first, resume) by the fresh ones.  Those
+	// after them, held from the end of the text, are already moved.
+	moveGap(first) ;
+	gapEnd += resume - first ;
+	length += delta ;
+	if (gapEnd - gapStart < (int) fresh.size()) {
+		int grow = max(fresh.size(), spans.size()) ;
+		spans.insert(spans.begin() + gapEnd, grow, TokenSpan()) ;
+		examinedEnds.insert(examinedEnds.begin() + gapEnd, grow, 0) ;
+		gapEnd += grow ;
+	}
+	for (size_t i = 0; i < fresh.size(); i++) {
+		spans[gapStart] = fresh[i] ;
+		examinedEnds[gapStart] = freshExamined[i] ;
+		gapStart ++ ;
 	}
-	newestToken = new Token("endOfFile", endOfFile, NULL);
-	if (startingToken == NULL) {
-		return newestToken;
+
+	// The look-ahead ends after them were moved too, which may
+	// overstate them but never understates them; only those the
+	// rescan looked past need raising.
+	for (size_t i = gapEnd; i < spans.size(); i++) {
+		if (examinedEnds[i] == INT_MAX || examinedEnds[i] + length >= furthest)
+			break ;
+		examinedEnds[i] = furthest - length ;
+	}
+	lastRescanned = fresh.size() ;
+}
+
+Token * Scanner::scan(const char *text) {
+	vector<TokenSpan> spans ;
+	scanSpans(text, spans) ;
+
+	// Builds the linked list from the back so that each Token can
+	// be given its successor as it is made.
+	Token *startingToken = new Token("endOfFile", endOfFile, NULL) ;
+	for (int i = (int) spans.size() - 2; i >= 0; i--) {
+		startingToken = new Token(spans[i].lexeme(text), spans[i].terminal, startingToken) ;
 	}
-	curToken->next = newestToken;
 	return startingToken;
 }
@@ -3,47 +3,27 @@
 
 #include <regex.h>
 #include <string>
+#include <vector>
 #include "regex.h"
+#include "dfa.h"
+#include "tokenList.h"
 
 class Token ;
 
 /* This enumerated type is used to keep track of what kind of
-   construct was matched. 
+   construct was matched.  The terminals are listed in tokenList.h.
  */
 
-enum tokenEnumType { 
-
-	intKwd, floatKwd, boolKwd,
-	trueKwd, falseKwd, stringKwd,  matrixKwd,
-	letKwd, inKwd, endKwd, ifKwd, thenKwd, elseKwd,
-	forKwd, whileKwd, printKwd,
-
-	// Constants
-	intConst, floatConst, stringConst, 
-
-	// Names
-	variableName ,
-
-	// Punctuation
-	leftParen, rightParen, 
-	leftCurly, rightCurly, 
-	leftSquare, rightSquare,
-
-	comma, semiColon, colon,
-
-	//Operators
-	assign, 
-	plusSign, star, dash, forwardSlash,
-	lessThan, lessThanEqual, greaterThan, greaterThanEqual,
-	equalsEquals, notEquals,
-	andOp, orOp, notOp,
-
-	// Special terminal types
-	endOfFile ,
-	lexicalError
+enum tokenEnumType {
+#define TOKEN_ENUM(name, pattern, description) name,
+	TOKEN_LIST(TOKEN_ENUM)
+#undef TOKEN_ENUM
 } ;
 typedef enum tokenEnumType tokenType ;
 
+// How error messages describe each terminal, indexed by tokenType.
+extern const char *const terminalDescriptions[lexicalError+1] ;
+
 // Below you need to write your class definitions for Token and Scanner.
 
 class Token {
@@ -54,59 +34,107 @@ class Token {
 		Token * next ;
 } ;
 
-class Scanner {
+/* A token that does not copy its lexeme: it records only where the
+   lexeme lies in the scanned text.  The text must outlive the span;
+   lexeme() makes a copy of the lexeme for the rare cases that need
+   one, such as names and constants in the AST.
+ */
+class TokenSpan {
 	public:
-		regex_t* regexes[lexicalError+1] ;
-		Scanner() {
-			regexes[intKwd] 			= makeRegex("^Int") ;
-			regexes[floatKwd] 			= makeRegex("^Float") ;
-			regexes[boolKwd]			= makeRegex("^Bool") ;
-			regexes[trueKwd]			= makeRegex("^True") ;
-			regexes[falseKwd] 			= makeRegex("^False") ;
-			regexes[stringKwd] 			= makeRegex("^Str") ;
-			regexes[matrixKwd] 			= makeRegex("^Matrix") ;
-			regexes[letKwd] 			= makeRegex("^let") ;
-			regexes[inKwd] 				= makeRegex("^in") ;
-			regexes[endKwd] 			= makeRegex("^end");
-			regexes[ifKwd] 				= makeRegex("^if") ;
-			regexes[thenKwd] 			= makeRegex("^then") ;
-			regexes[elseKwd] 			= makeRegex("^else") ;
-			regexes[forKwd] 			= makeRegex("^for") ;
-			regexes[whileKwd] 			= makeRegex("^while") ;
-			regexes[printKwd] 			= makeRegex("^print") ;
-			regexes[intConst]   		= makeRegex("^[0-9]+") ;
-			regexes[floatConst] 		= makeRegex("^[0-9]*\\.?[0-9]*") ;
-			regexes[stringConst] 		= makeRegex("^\"(\\.|[^\"])*\"");
-			regexes[variableName] 		= makeRegex("^[a-zA-Z_][a-zA-Z_0-9]*") ; 
-			regexes[leftParen] 			= makeRegex("^\\(") ;
-			regexes[rightParen] 		= makeRegex("^)") ;
-			regexes[leftCurly] 			= makeRegex("^\\{") ;
-			regexes[rightCurly] 		= makeRegex("^}") ;
-			regexes[leftSquare] 		= makeRegex("^\\[") ;
-			regexes[rightSquare] 		= makeRegex("^]") ;
-			regexes[comma] 				= makeRegex("^,") ;
-			regexes[semiColon] 			= makeRegex("^;") ;
-			regexes[colon] 				= makeRegex("^:") ;
-			regexes[assign] 			= makeRegex("^=") ;
-			regexes[plusSign] 			= makeRegex("^\\+") ;
-			regexes[star] 				= makeRegex("^\\*") ;
-			regexes[dash] 				= makeRegex("^-") ;
-			regexes[forwardSlash] 		= makeRegex("^/") ;
-			regexes[lessThan] 			= makeRegex("^<") ;
-			regexes[lessThanEqual] 		= makeRegex("^<=") ;
-			regexes[greaterThan] 		= makeRegex("^>") ;
-			regexes[greaterThanEqual]	= makeRegex("^>=") ;
-			regexes[equalsEquals] 		= makeRegex("^==") ;
-			regexes[notEquals] 			= makeRegex("^!=") ;
-			regexes[andOp] 				= makeRegex("^&&") ;
-			regexes[orOp] 				= makeRegex("^\\|\\|") ;
-			regexes[notOp] 				= makeRegex("^!") ;
-			regexes[endOfFile] 			= makeRegex("^EOF") ;
-			regexes[lexicalError] 		= makeRegex("[^ ]") ;
+		TokenSpan () : offset(0), length(0), terminal(endOfFile) { }
+		TokenSpan (int o, int l, tokenType t) : offset(o), length(l), terminal(t) { }
+		std::string lexeme (const char *text) const {
+			return std::string (text + offset, length) ;
 		}
+		int offset ;
+		int length ;
+		tokenType terminal ;
+} ;
+
+/* The Scanner can recognize tokens in two ways.  The regexEngine
+   tries each of the token regexes in turn and keeps the longest match;
+   it is the reference implementation.  The dfaEngine compiles the same
+   patterns into a single automaton that examines each character once.
+   Both give the longest match, preferring the earlier tokenType on a
+   tie.
+ */
+enum scannerEngineEnumType { regexEngine, dfaEngine } ;
+typedef enum scannerEngineEnumType scannerEngineType ;
+
+/* The compiled patterns used by one scanner engine.  Each engine's
+   tables are built the first time a Scanner asks for them and are
+   never modified afterwards, so they are shared, read-only, by every
+   Scanner in the process and in every thread.
+ */
+class ScannerTables {
+	public:
+		static const ScannerTables &get (scannerEngineType e) ;
+		const regex_t *regexes[lexicalError+1] ;
+		const regex_t *whiteSpace ;
+		const regex_t *blockComment ;
+		const regex_t *lineComment ;
+		const DFA *tokenDFA ;
+	private:
+		ScannerTables (scannerEngineType e) ;
+		ScannerTables (const ScannerTables &) ;
+} ;
+
+class Scanner {
+	public:
+		Scanner (scannerEngineType e = dfaEngine) ;
+		scannerEngineType engine ;
+		const ScannerTables *tables ;
 		Token * scan(const char *text) ;
+		void scanSpans(const char *text, std::vector<TokenSpan> &spans) ;
+		TokenSpan scanNext(const char *text, int *offset, int *examined = NULL) ;
+		void scanSpansParallel(const char *text, std::vector<TokenSpan> &spans,
+		                       int numThreads = 0, int minChunkSize = 1 << 16) ;
 		Token * matchNextToken(const char *text) ;
-		int consumeWhiteSpaceAndComments (regex_t *whiteSpace, regex_t *blockComment, regex_t *lineComment, const char *text) ;
+		TokenSpan matchNextSpan(const char *text, int *examined = NULL) ;
+		int consumeWhiteSpaceAndComments (const regex_t *whiteSpace, const regex_t *blockComment, const regex_t *lineComment, const char *text) ;
+		int consumeWhiteSpaceAndComments (const char *text) ;
+} ;
+
+/* Keeps the tokens of a text up to date as the text is edited.  After
+   an edit, scanning restarts at the first token whose scan looked at
+   a changed character, and stops as soon as it reaches an offset, past
+   the edit, at which the old scan also started a token: from there on
+   the old tokens are still right, only moved by the edit.
+
+   The tokens are kept in a gap buffer, with the gap where the last
+   edit was.  Tokens before the gap hold offsets from the start of the
+   text, and those after it offsets from its end, so an edit moves
+   them without touching them.  An edit costs the tokens it rescans,
+   plus those the gap moves over to reach it: editing near the last
+   edit is cheap, while jumping across the text moves every token in
+   between once.
+ */
+class IncrementalScanner {
+	public:
+		IncrementalScanner (Scanner *s)
+			: lastRescanned(0), scanner(s), length(0), gapStart(0), gapEnd(0) { }
+		void scan (const char *text) ;
+		// [text] is the edited text, in which [insertedLength] chars
+		// at [offset] replaced [removedLength] chars.
+		void edit (const char *text, int offset, int removedLength, int insertedLength) ;
+		int size () const { return spans.size() - (gapEnd - gapStart) ; }
+		TokenSpan token (int i) const ;
+		// All of the tokens, which takes time in their number.
+		std::vector<TokenSpan> tokens () const ;
+		int lastRescanned ;		// tokens scanned by the last scan or edit
+	private:
+		int examinedEnd (int i) const ;
+		int oldStart (int i) const ;
+		void moveGap (int to) ;
+		Scanner *scanner ;
+		int length ;			// of the text
+		// spans[gapStart..gapEnd) is the gap.
+		std::vector<TokenSpan> spans ;
+		// The most that the scans of the tokens up to each one looked
+		// ahead: one past the last offset looked at, or INT_MAX if
+		// unknown.  Relative to the end of the text after the gap too.
+		std::vector<int> examinedEnds ;
+		int gapStart, gapEnd ;
 } ;
 
 #endif /* SCANNER_H */
@@ -3,6 +3,9 @@
 #include "readInput.h"
 #include "scanner.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 using namespace std ;
 
 class ScannerTestSuite : public CxxTest::TestSuite 
@@ -314,6 +317,24 @@ public:
         TS_ASSERT ( sameTerminals ( tks, 4, ts ) ) ;
     }
 
+    // Spans locate each lexeme in the text instead of copying it.
+    void test_scanSpans_nums_vars ( ) {
+        const char *text = " 123 x 12.34 " ;
+        vector<TokenSpan> spans ;
+        s->scanSpans (text, spans) ;
+        TS_ASSERT_EQUALS (spans.size(), 4u) ;
+        TS_ASSERT_EQUALS (spans[0].terminal, intConst) ;
+        TS_ASSERT_EQUALS (spans[0].offset, 1) ;
+        TS_ASSERT_EQUALS (spans[0].lexeme(text), "123") ;
+        TS_ASSERT_EQUALS (spans[1].terminal, variableName) ;
+        TS_ASSERT_EQUALS (spans[1].lexeme(text), "x") ;
+        TS_ASSERT_EQUALS (spans[2].terminal, floatConst) ;
+        TS_ASSERT_EQUALS (spans[2].lexeme(text), "12.34") ;
+        TS_ASSERT_EQUALS (spans[3].terminal, endOfFile) ;
+        TS_ASSERT_EQUALS (spans[3].offset, 13) ;
+        TS_ASSERT_EQUALS (spans[3].length, 0) ;
+    }
+
 
 
     /* This test checks that the scanner returns a list of tokens with
@@ -363,6 +384,203 @@ public:
         scanFileNoLexicalErrors ("../samples/forest_loss_v2.dsl") ;
     }
 
+    // Scanning a SourceBuffer gives the same spans as scanning a copy.
+    void test_scan_sourceBuffer ( ) {
+        const char *filename = "../samples/forest_loss_v2.dsl" ;
+        char *copy = readInputFromFile ( filename ) ;
+        SourceBuffer source ( filename ) ;
+        TS_ASSERT ( copy && source.text() ) ;
+        TS_ASSERT ( source.isMapped() ) ;
+        TS_ASSERT_EQUALS ( source.size(), strlen(copy) ) ;
+        TS_ASSERT_EQUALS ( source.text()[source.size()], '\0' ) ;
+        vector<TokenSpan> expected, actual ;
+        s->scanSpans ( copy, expected ) ;
+        s->scanSpans ( source.text(), actual ) ;
+        TS_ASSERT_EQUALS ( actual.size(), expected.size() ) ;
+        for (size_t i = 0; i < actual.size() && i < expected.size(); i ++) {
+            TS_ASSERT_EQUALS ( actual[i].offset, expected[i].offset ) ;
+            TS_ASSERT_EQUALS ( actual[i].terminal, expected[i].terminal ) ;
+        }
+        free ( copy ) ;
+    }
+
+    // The parallel scan must give exactly the tokens of scanSpans.
+    void sameSpansParallel ( const char *text, int numThreads, int minChunkSize ) {
+        vector<TokenSpan> expected, actual ;
+        s->scanSpans ( text, expected ) ;
+        s->scanSpansParallel ( text, actual, numThreads, minChunkSize ) ;
+        TS_ASSERT_EQUALS ( actual.size(), expected.size() ) ;
+        for (size_t i = 0; i < actual.size() && i < expected.size(); i ++) {
+            TS_ASSERT_EQUALS ( actual[i].offset, expected[i].offset ) ;
+            TS_ASSERT_EQUALS ( actual[i].length, expected[i].length ) ;
+            TS_ASSERT_EQUALS ( actual[i].terminal, expected[i].terminal ) ;
+        }
+    }
+
+    void test_scanSpansParallel_samples ( ) {
+        char *text = readInputFromFile ( "../samples/forest_loss_v2.dsl" ) ;
+        TS_ASSERT ( text ) ;
+        string big ;
+        while (big.size() < (1 << 20))
+            big += text ;
+        sameSpansParallel ( big.c_str(), 0, 1 << 16 ) ;
+        sameSpansParallel ( big.c_str(), 8, 1 << 16 ) ;
+        sameSpansParallel ( text, 16, 1 ) ;
+        free ( text ) ;
+    }
+
+    // Chunks that start inside strings and comments are stitched back.
+    void test_scanSpansParallel_boundaries ( ) {
+        const char *text =
+            "x = 1 ;\n/* a comment\nspanning \"lines\"\n*/ y = \"a\nstring\" ;\n"
+            "// line comment \"\n z = 2.5 ;\n/* \\ not\n a comment */\n"
+            "w = \"\n/*\n\" ; v = 3 ;\n\n\n" ;
+        for (int threads = 2; threads < 40; threads ++)
+            sameSpansParallel ( text, threads, 1 ) ;
+        sameSpansParallel ( "", 4, 1 ) ;
+        sameSpansParallel ( "\n\n\n\n", 4, 1 ) ;
+    }
+
+    // After each edit the tokens must be those of a full scan.
+    void sameSpansIncremental ( IncrementalScanner &inc, const string &text ) {
+        vector<TokenSpan> expected ;
+        s->scanSpans ( text.c_str(), expected ) ;
+        TS_ASSERT_EQUALS ( inc.size(), (int) expected.size() ) ;
+        for (int i = 0; i < inc.size() && i < (int) expected.size(); i ++) {
+            TS_ASSERT_EQUALS ( inc.token(i).offset, expected[i].offset ) ;
+            TS_ASSERT_EQUALS ( inc.token(i).length, expected[i].length ) ;
+            TS_ASSERT_EQUALS ( inc.token(i).terminal, expected[i].terminal ) ;
+        }
+        TS_ASSERT_EQUALS ( inc.tokens().size(), expected.size() ) ;
+    }
+
+    void test_incremental_random_edits ( ) {
+        const char *pieces[] = { "/*", "*/", "\"", "in", "t", "\n", "//", " ",
+                                 "\\", "1.", "5", "x = ", "<", "=", "end", "" } ;
+        char *sample = readInputFromFile ( "../samples/sample_1.dsl" ) ;
+        TS_ASSERT ( sample ) ;
+        string text ( sample ) ;
+        free ( sample ) ;
+
+        IncrementalScanner inc ( s ) ;
+        inc.scan ( text.c_str() ) ;
+        unsigned int seed = 12345 ;
+        for (int n = 0; n < 500; n ++) {
+            seed = seed * 1103515245 + 12345 ;
+            int offset = (seed >> 8) % (text.size() + 1) ;
+            int removed = min ((int) ((seed >> 4) % 4), (int) text.size() - offset) ;
+            string inserted = pieces[(seed >> 16) % 16] ;
+            text.replace ( offset, removed, inserted ) ;
+            inc.edit ( text.c_str(), offset, removed, inserted.size() ) ;
+            sameSpansIncremental ( inc, text ) ;
+        }
+    }
+
+    // A small edit to a large text rescans only a few tokens.
+    void test_incremental_local_edit ( ) {
+        string text ;
+        for (int i = 0; i < 10000; i ++)
+            text += "x = x + 1 ; /* step */\n" ;
+        IncrementalScanner inc ( s ) ;
+        inc.scan ( text.c_str() ) ;
+        int offset = text.size() / 2 ;
+        offset = text.find ( "1", offset ) ;
+        text.replace ( offset, 1, "42" ) ;
+        inc.edit ( text.c_str(), offset, 1, 2 ) ;
+        sameSpansIncremental ( inc, text ) ;
+        TS_ASSERT_LESS_THAN ( inc.lastRescanned, 5 ) ;
+    }
+
+    // A file filling whole pages still gets its sentinel.
+    void test_sourceBuffer_page_sized_file ( ) {
+        const char *filename = "sourceBuffer_test.dsl" ;
+        size_t size = sysconf ( _SC_PAGESIZE ) ;
+        FILE *out = fopen ( filename, "w" ) ;
+        TS_ASSERT ( out ) ;
+        for (size_t i = 0; i < size; i ++)
+            fputc ( 'x', out ) ;
+        fclose ( out ) ;
+
+        SourceBuffer source ( filename ) ;
+        TS_ASSERT_EQUALS ( source.size(), size ) ;
+        TS_ASSERT_EQUALS ( source.text()[size], '\0' ) ;
+        source.close () ;
+        TS_ASSERT ( source.text() == NULL ) ;
+        TS_ASSERT ( ! source.open ( "no_such_file.dsl" ) ) ;
+        remove ( filename ) ;
+    }
+
+
+    // Cross-checks of the dfaEngine against the regexEngine
+    // --------------------------------------------------
+
+    /* Both engines must produce the same list of tokens, with the
+       same terminals and lexemes.
+     */
+    void sameTokensBothEngines ( const char *text ) {
+        Scanner regexScanner (regexEngine) ;
+        Scanner dfaScanner (dfaEngine) ;
+        Token *expected = regexScanner.scan ( text ) ;
+        Token *actual = dfaScanner.scan ( text ) ;
+        while (expected != NULL && actual != NULL) {
+            TS_ASSERT_EQUALS (actual->terminal, expected->terminal) ;
+            TS_ASSERT_EQUALS (actual->lexeme, expected->lexeme) ;
+            expected = expected->next ;
+            actual = actual->next ;
+        }
+        TS_ASSERT (expected == NULL && actual == NULL) ;
+    }
+
+    void sameTokensBothEnginesFile ( const char *filename ) {
+        char *text = readInputFromFile ( filename ) ;
+        TS_ASSERT ( text ) ;
+        sameTokensBothEngines ( text ) ;
+    }
+
+    // Compiled patterns are built once and shared by every Scanner.
+    void test_scanners_share_tables ( ) {
+        Scanner a, b ;
+        TS_ASSERT_EQUALS (a.tables, b.tables) ;
+        TS_ASSERT (a.tables->tokenDFA != NULL) ;
+        Scanner c (regexEngine), d (regexEngine) ;
+        TS_ASSERT_EQUALS (c.tables, d.tables) ;
+        TS_ASSERT (c.tables->regexes[intKwd] != NULL) ;
+        TS_ASSERT (c.tables->whiteSpace != NULL) ;
+    }
+
+    void test_engines_agree_tricky_lexemes ( ) {
+        sameTokensBothEngines ( "interval in endx end EOF Integer Int_ 1. . .5 12.34.5" ) ;
+        sameTokensBothEngines ( "<<= >== !!= &&& ||| \"a\nb\" \"open" ) ;
+        sameTokensBothEngines ( "/* a\\b */ x /* unclosed" ) ;
+        sameTokensBothEngines ( "x // no newline at the end" ) ;
+        sameTokensBothEngines ( "/**/ /***/ /* * / **/ y\t\r\n @ # $" ) ;
+    }
+
+    // Every keyword, and names that share its first and last characters
+    // and length or that extend it, must be classified as by the regexes.
+    void test_engines_agree_keywords ( ) {
+        sameTokensBothEngines ( "Int Float Bool True False Str Matrix let in end "
+                                "if then else for while print" ) ;
+        sameTokensBothEngines ( "Iat Fleat Bl Trie Falsee Sr Mx lt inn ed "
+                                "iff ten ese fr whle pint _in in_ in2 IN" ) ;
+        sameTokensBothEngines ( "Int(x)+let;while{print}else,if[in]end" ) ;
+    }
+
+    void test_engines_agree_samples ( ) {
+        sameTokensBothEnginesFile ("../samples/bad_syntax_good_tokens.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_1.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_2.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_3.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_4.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_5.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_6.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_7.dsl") ;
+        sameTokensBothEnginesFile ("../samples/sample_8.dsl") ;
+        sameTokensBothEnginesFile ("../samples/my_sample_5.dsl") ;
+        sameTokensBothEnginesFile ("../samples/mysample.dsl") ;
+        sameTokensBothEnginesFile ("../samples/forest_loss_v2.dsl") ;
+    }
+
       
 
 } ;
@@ -0,0 +1,166 @@
+/* skipper.cpp
+
+   This file provides [skipWhiteSpaceAndComments] and [bestSkipper].
+
+   All of the work is done by a search for the first byte that is (or
+   is not) one of four given bytes.  The vector versions read aligned
+   blocks, starting with the block that holds the first byte, so a
+   read never crosses into a page that holds none of the text.
+
+   Those blocks may still hold bytes before the text or after its
+   '\0', which AddressSanitizer reports as out of bounds though they
+   are never used, so it does not instrument the vector versions.
+ */
+
+#include <stdint.h>
+
+#include "skipper.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SKIPPER_X86
+#include <immintrin.h>
+#endif
+
+/* Each search returns a pointer to the first byte at or after [p]
+   that is one of set[0..3] (if [inSet]) or that is none of them.  The
+   caller makes sure the search stops at the '\0' at the end of the
+   text: '\0' is in the set, or, when [inSet] is false, is not.
+ */
+typedef const char *(*searchFunction) (const char *p, const char *set, bool inSet) ;
+
+static const char *searchScalar (const char *p, const char *set, bool inSet) {
+    while (((*p == set[0]) | (*p == set[1]) | (*p == set[2]) | (*p == set[3])) != inSet)
+        p ++ ;
+    return p ;
+}
+
+#ifdef SKIPPER_X86
+
+__attribute__ ((target ("sse2"), no_sanitize_address))
+static const char *searchSSE2 (const char *p, const char *set, bool inSet) {
+    const __m128i c0 = _mm_set1_epi8 (set[0]) ;
+    const __m128i c1 = _mm_set1_epi8 (set[1]) ;
+    const __m128i c2 = _mm_set1_epi8 (set[2]) ;
+    const __m128i c3 = _mm_set1_epi8 (set[3]) ;
+    const unsigned int flip = inSet ? 0 : 0xFFFF ;
+
+    uintptr_t misalign = (uintptr_t) p & 15 ;
+    const __m128i *block = (const __m128i *) (p - misalign) ;
+    unsigned int ignore = ~0u << misalign ;   // bytes before [p]
+    for ( ; ; block ++, ignore = ~0u) {
+        __m128i v = _mm_load_si128 (block) ;
+        __m128i eq = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (v, c0), _mm_cmpeq_epi8 (v, c1)),
+                                   _mm_or_si128 (_mm_cmpeq_epi8 (v, c2), _mm_cmpeq_epi8 (v, c3))) ;
+        unsigned int hits = ((unsigned int) _mm_movemask_epi8 (eq) ^ flip) & ignore ;
+        if (hits != 0)
+            return (const char *) block + __builtin_ctz (hits) ;
+    }
+}
+
+__attribute__ ((target ("avx2"), no_sanitize_address))
+static const char *searchAVX2 (const char *p, const char *set, bool inSet) {
+    const __m256i c0 = _mm256_set1_epi8 (set[0]) ;
+    const __m256i c1 = _mm256_set1_epi8 (set[1]) ;
+    const __m256i c2 = _mm256_set1_epi8 (set[2]) ;
+    const __m256i c3 = _mm256_set1_epi8 (set[3]) ;
+    const unsigned int flip = inSet ? 0 : 0xFFFFFFFFu ;
+
+    uintptr_t misalign = (uintptr_t) p & 31 ;
+    const __m256i *block = (const __m256i *) (p - misalign) ;
+    unsigned int ignore = ~0u << misalign ;   // bytes before [p]
+    for ( ; ; block ++, ignore = ~0u) {
+        __m256i v = _mm256_load_si256 (block) ;
+        __m256i eq = _mm256_or_si256 (_mm256_or_si256 (_mm256_cmpeq_epi8 (v, c0), _mm256_cmpeq_epi8 (v, c1)),
+                                      _mm256_or_si256 (_mm256_cmpeq_epi8 (v, c2), _mm256_cmpeq_epi8 (v, c3))) ;
+        unsigned int hits = ((unsigned int) _mm256_movemask_epi8 (eq) ^ flip) & ignore ;
+        if (hits != 0)
+            return (const char *) block + __builtin_ctz (hits) ;
+    }
+}
+
+#endif /* SKIPPER_X86 */
+
+skipperType bestSkipper () {
+#ifdef SKIPPER_X86
+    // Function-local statics are initialized once, even with threads.
+    static const skipperType best =
+        __builtin_cpu_supports ("avx2") ? avx2Skipper :
+        __builtin_cpu_supports ("sse2") ? sse2Skipper : scalarSkipper ;
+    return best ;
+#else
+    return scalarSkipper ;
+#endif
+}
+
+static searchFunction searchFor (skipperType skipper) {
+#ifdef SKIPPER_X86
+    // A skipper the CPU lacks is replaced by the best it has.
+    if (skipper > bestSkipper())
+        skipper = bestSkipper() ;
+    if (skipper == avx2Skipper)
+        return searchAVX2 ;
+    if (skipper == sse2Skipper)
+        return searchSSE2 ;
+#endif
+    return searchScalar ;
+}
+
+static const char whiteSpaceChars[4] = { ' ', '\t', '\n', '\r' } ;
+static const char blockCommentStops[4] = { '*', '\\', '\0', '\0' } ;
+static const char lineCommentStops[4] = { '\n', '\0', '\0', '\0' } ;
+
+int skipWhiteSpaceAndComments (const char *text, skipperType skipper, int *examined) {
+    searchFunction search = searchFor (skipper) ;
+    const char *p = text ;
+    const char *end = text ;    // one past the last character looked at
+
+    while (true) {
+        p = search (p, whiteSpaceChars, false) ;
+        end = p + 1 ;
+        if (p[0] != '/')
+            break ;
+        end = p + 2 ;
+
+        if (p[1] == '*') {
+            // The comment ends at the first "*/" after the "/*", as
+            // long as no '\' or '\0' comes before it.
+            const char *q = p + 2 ;
+            while (true) {
+                q = search (q, blockCommentStops, true) ;
+                end = q + 1 ;
+                if (*q != '*') {
+                    *examined = end - text ;
+                    return p - text ;
+                }
+                end = q + 2 ;
+                if (q[1] == '/')
+                    break ;
+                q ++ ;
+            }
+            p = q + 2 ;
+        }
+        else if (p[1] == '/') {
+            const char *q = search (p + 2, lineCommentStops, true) ;
+            end = q + 1 ;
+            if (*q != '\n') {
+                *examined = end - text ;
+                return p - text ;
+            }
+            p = q + 1 ;
+        }
+        else
+            break ;
+    }
+    *examined = end - text ;
+    return p - text ;
+}
+
+int skipWhiteSpaceAndComments (const char *text, skipperType skipper) {
+    int examined ;
+    return skipWhiteSpaceAndComments (text, skipper, &examined) ;
+}
+
+int skipWhiteSpaceAndComments (const char *text) {
+    int examined ;
+    return skipWhiteSpaceAndComments (text, bestSkipper(), &examined) ;
+}
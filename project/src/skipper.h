@@ -0,0 +1,32 @@
+/* skipper.h
+
+   This file declares [skipWhiteSpaceAndComments], which finds the
+   length of the white space, block comments and single-line comments
+   at the start of a text.  It accepts exactly what the Scanner's
+   white space and comment regexes (skipPatterns in scanner.cpp)
+   accept.  As with regcomp, a backslash inside a bracket expression
+   is an ordinary character, so a block comment may not contain a
+   backslash, and a single-line comment must end with a newline.
+
+   Runs of white space and the bodies of comments are searched 16
+   (SSE2) or 32 (AVX2) bytes at a time, chosen by the CPU the program
+   runs on, with a plain loop as the fallback.
+ */
+#ifndef SKIPPER_H
+#define SKIPPER_H
+
+enum skipperEnumType { scalarSkipper, sse2Skipper, avx2Skipper } ;
+typedef enum skipperEnumType skipperType ;
+
+// The fastest skipper this CPU supports.
+skipperType bestSkipper () ;
+
+int skipWhiteSpaceAndComments (const char *text) ;
+int skipWhiteSpaceAndComments (const char *text, skipperType skipper) ;
+
+/* As above, and stores in [examined] the number of characters that
+   were looked at to decide (counting a terminating '\0').
+ */
+int skipWhiteSpaceAndComments (const char *text, skipperType skipper, int *examined) ;
+
+#endif /* SKIPPER_H */
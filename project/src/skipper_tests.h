@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+#include "skipper.h"
+
+#include <string>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+using namespace std ;
+
+class SkipperTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    // Tests for skipWhiteSpaceAndComments
+    // --------------------------------------------------
+    /* Every skipper must give the same length; on a CPU without AVX2
+       or SSE2 the request falls back to a skipper it has.
+     */
+    void sameSkipAll ( const char *text, int expected ) {
+        TS_ASSERT_EQUALS (skipWhiteSpaceAndComments (text, scalarSkipper), expected) ;
+        TS_ASSERT_EQUALS (skipWhiteSpaceAndComments (text, sse2Skipper), expected) ;
+        TS_ASSERT_EQUALS (skipWhiteSpaceAndComments (text, avx2Skipper), expected) ;
+        TS_ASSERT_EQUALS (skipWhiteSpaceAndComments (text), expected) ;
+    }
+
+    void test_skip_white_space ( void ) {
+        sameSkipAll ("", 0) ;
+        sameSkipAll ("x", 0) ;
+        sameSkipAll (" \t\r\n x", 5) ;
+        sameSkipAll ("   ", 3) ;
+        sameSkipAll ("\v x", 0) ;
+    }
+
+    void test_skip_block_comments ( void ) {
+        sameSkipAll ("/**/x", 4) ;
+        sameSkipAll ("/***/x", 5) ;
+        sameSkipAll ("/* * / **/ y", 11) ;
+        sameSkipAll ("/*/ x */y", 8) ;
+        sameSkipAll ("/* a */ /* b */ c", 16) ;
+        sameSkipAll ("/* unclosed", 0) ;
+        sameSkipAll ("  /* unclosed", 2) ;
+    }
+
+    // As with regcomp, a '\' may not appear in a block comment.
+    void test_skip_block_comment_backslash ( void ) {
+        sameSkipAll ("/* a\\b */ x", 0) ;
+        sameSkipAll (" /* a *\\/ */ x", 1) ;
+        sameSkipAll ("/* a */\\", 7) ;
+    }
+
+    // A single-line comment must end with a newline.
+    void test_skip_line_comments ( void ) {
+        sameSkipAll ("// a\nx", 5) ;
+        sameSkipAll ("//\n//\nx", 6) ;
+        sameSkipAll ("// no newline", 0) ;
+        sameSkipAll ("// a /* b\n*/", 10) ;
+        sameSkipAll ("/ x", 0) ;
+    }
+
+    // Long runs cross many vector blocks, starting at every alignment.
+    void test_skip_long_runs ( void ) {
+        string body = "/*" + string(200, ' ') + "*" + string(70, 'x') + "*/"
+            + string(100, '\n') + "//" + string(90, 'y') + "\n" ;
+        for (int pad = 0; pad < 40; pad ++) {
+            string text = string(pad, 'z') + body + "end" ;
+            sameSkipAll (text.c_str() + pad, body.size()) ;
+        }
+    }
+
+    // A text that ends at the end of a page is read no further.
+    void test_skip_end_of_page ( void ) {
+        size_t page = sysconf (_SC_PAGESIZE) ;
+        char *mem = (char *) mmap (NULL, 2 * page, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) ;
+        TS_ASSERT (mem != MAP_FAILED) ;
+        TS_ASSERT (mprotect (mem + page, page, PROT_NONE) == 0) ;
+        memset (mem, ' ', page - 1) ;
+        mem[page-1] = '\0' ;
+        sameSkipAll (mem, page - 1) ;
+        sameSkipAll (mem + page - 1, 0) ;
+        munmap (mem, 2 * page) ;
+    }
+
+} ;
@@ -0,0 +1,30 @@
+/* stringPool.cpp
+
+   This file provides the [StringPool] class.
+ */
+
+#include <string.h>
+
+#include "stringPool.h"
+
+using namespace std ;
+
+uint32_t StringPool::intern (const char *s, size_t length) {
+    unordered_map<string_view, uint32_t>::const_iterator found = ids.find (string_view (s, length)) ;
+    if (found != ids.end())
+        return found->second ;
+
+    char *copy = (char *) chars.allocate (length + 1, 1) ;
+    memcpy (copy, s, length) ;
+    copy[length] = '\0' ;
+    uint32_t id = strings.size() ;
+    strings.push_back (string_view (copy, length)) ;
+    ids[strings.back()] = id ;
+    return id ;
+}
+
+void StringPool::clear () {
+    ids.clear() ;
+    strings.clear() ;
+    chars.release() ;
+}
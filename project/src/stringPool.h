@@ -0,0 +1,42 @@
+/* stringPool.h
+
+   This file declares the [StringPool] class, which interns strings:
+   each distinct string is stored once and named by a 32-bit id, so
+   identifiers can be stored and compared as integers.
+
+   The characters live in an Arena and never move, so the pointer
+   returned by [str] is valid as long as the pool.
+ */
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.h"
+
+class StringPool {
+public:
+    StringPool () : chars(16 * 1024) { }
+
+    // The id of the string, adding it if it is new.
+    uint32_t intern (const char *s, size_t length) ;
+    uint32_t intern (const std::string &s) { return intern (s.data(), s.size()) ; }
+
+    // The '\0'-terminated characters and the length of string [id].
+    const char *str (uint32_t id) const { return strings[id].data() ; }
+    size_t length (uint32_t id) const { return strings[id].size() ; }
+
+    size_t size () const { return strings.size() ; }
+    void clear () ;
+
+private:
+    Arena chars ;
+    std::vector<std::string_view> strings ;
+    std::unordered_map<std::string_view, uint32_t> ids ;
+} ;
+
+#endif /* STRINGPOOL_H */
@@ -0,0 +1,53 @@
+#include <cxxtest/TestSuite.h>
+#include "stringPool.h"
+
+#include <string>
+#include <string.h>
+#include <stdio.h>
+
+using namespace std ;
+
+class StringPoolTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    // Tests for StringPool
+    // --------------------------------------------------
+
+    void test_intern ( void ) {
+        StringPool pool ;
+        uint32_t x = pool.intern ("x") ;
+        uint32_t y = pool.intern (string ("y")) ;
+        TS_ASSERT_DIFFERS (x, y) ;
+        TS_ASSERT_EQUALS (pool.intern ("x", 1), x) ;
+        TS_ASSERT_EQUALS (pool.intern ("xyz", 1), x) ;
+        TS_ASSERT_EQUALS (strcmp (pool.str (y), "y"), 0) ;
+        TS_ASSERT_EQUALS (pool.length (x), 1u) ;
+        TS_ASSERT_EQUALS (pool.size (), 2u) ;
+
+        // The empty string and strings holding '\0' are strings too.
+        uint32_t empty = pool.intern ("", 0) ;
+        uint32_t nul = pool.intern ("a\0b", 3) ;
+        TS_ASSERT_EQUALS (pool.length (empty), 0u) ;
+        TS_ASSERT_EQUALS (pool.length (nul), 3u) ;
+        TS_ASSERT_DIFFERS (pool.intern ("a", 1), nul) ;
+    }
+
+    // Strings do not move as the pool grows.
+    void test_many ( void ) {
+        StringPool pool ;
+        const char *first = pool.str (pool.intern ("name0")) ;
+        char name[32] ;
+        for (int i = 0; i < 20000; i ++) {
+            snprintf (name, sizeof name, "name%d", i) ;
+            TS_ASSERT_EQUALS (pool.intern (name), (uint32_t) i) ;
+        }
+        TS_ASSERT_EQUALS (pool.str (0), first) ;
+        TS_ASSERT_EQUALS (strcmp (pool.str (12345), "name12345"), 0) ;
+
+        pool.clear () ;
+        TS_ASSERT_EQUALS (pool.size (), 0u) ;
+        TS_ASSERT_EQUALS (pool.intern ("name7"), 0u) ;
+    }
+
+} ;
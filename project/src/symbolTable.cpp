@@ -0,0 +1,165 @@
+/* symbolTable.cpp
+
+   This file provides [SymbolTable] and [NameResolver].
+ */
+
+#include "symbolTable.h"
+
+using namespace std ;
+
+////////////////////////////////////////////////
+//
+//	SymbolTable
+//
+////////////////////////////////////////////////
+
+void SymbolTable::clear () {
+	names.clear () ;
+	symbols.clear () ;
+	visible.clear () ;
+	scoped.clear () ;
+	scopeStarts.assign (1, 0) ;
+	diagnostics.clear () ;
+}
+
+void SymbolTable::enterScope () {
+	scopeStarts.push_back (scoped.size()) ;
+}
+
+void SymbolTable::exitScope () {
+	size_t start = scopeStarts.back() ;
+	while (scoped.size() > start) {
+		const Symbol &s = symbols[scoped.back()] ;
+		visible[s.name] = s.hidden ;
+		scoped.pop_back () ;
+	}
+	scopeStarts.pop_back () ;
+}
+
+SymbolId SymbolTable::declare (uint32_t name, symbolKind kind, const string &type, Node *decl) {
+	if (name >= visible.size())
+		visible.resize (name + 1, noSymbol) ;
+
+	SymbolId hidden = visible[name] ;
+	if (hidden != noSymbol && symbols[hidden].depth == depth())
+		diagnostics.push_back (string(names.str (name)) + " is declared twice in the same scope") ;
+
+	Symbol s = { name, kind, type, depth(), false, decl, hidden } ;
+	SymbolId id = symbols.size() ;
+	symbols.push_back (s) ;
+	visible[name] = id ;
+	if (depth() > 0)
+		scoped.push_back (id) ;
+	return id ;
+}
+
+SymbolId SymbolTable::declareFunction (uint32_t name) {
+	if (name >= visible.size())
+		visible.resize (name + 1, noSymbol) ;
+
+	// The outermost scope is the end of the chain of Symbols that
+	// hide one another.
+	SymbolId last = noSymbol ;
+	for (SymbolId i = visible[name]; i != noSymbol; i = symbols[i].hidden) {
+		if (symbols[i].kind == functionSymbol)
+			return i ;
+		last = i ;
+	}
+
+	Symbol s = { name, functionSymbol, "", 0, false, NULL, noSymbol } ;
+	SymbolId id = symbols.size() ;
+	symbols.push_back (s) ;
+	if (last == noSymbol)
+		visible[name] = id ;
+	else
+		symbols[last].hidden = id ;
+	return id ;
+}
+
+////////////////////////////////////////////////
+//
+//	NameResolver
+//
+////////////////////////////////////////////////
+
+void NameResolver::declare (VarName *v, symbolKind kind, const string &type, Node *decl) {
+	v->nameId = table.names.intern (v->lexeme) ;
+	v->symbol = table.declare (v->nameId, kind, type, decl) ;
+}
+
+Node *NameResolver::visitRoot (Root *n) {
+	table.clear () ;
+	VarName *v = n->varName ;
+	v->nameId = table.names.intern (v->lexeme) ;
+	v->symbol = table.declareFunction (v->nameId) ;
+	table.symbol (v->symbol).decl = n ;
+
+	table.enterScope () ;
+	n->stmts = visitStmts (n->stmts) ;
+	table.exitScope () ;
+	return n ;
+}
+
+Node *NameResolver::visitStmtBlock (StmtBlock *n) {
+	table.enterScope () ;
+	visitChildren (n) ;
+	table.exitScope () ;
+	return n ;
+}
+
+Node *NameResolver::visitLetExpr (LetExpr *n) {
+	table.enterScope () ;
+	visitChildren (n) ;
+	table.exitScope () ;
+	return n ;
+}
+
+Node *NameResolver::visitStandardDecl (StandardDecl *n) {
+	declare (n->varName, scalarSymbol, n->typeKeyword, n) ;
+	return n ;
+}
+
+Node *NameResolver::visitMatrixDecl (MatrixDecl *n) {
+	n->expr = visitExpr (n->expr) ;
+	declare (n->varName, matrixSymbol, "Matrix", n) ;
+	return n ;
+}
+
+// The matrix is declared before its initializer, as the C++ for it
+// is, and the index variables only in the initializer.
+Node *NameResolver::visitMatrixAdvDecl (MatrixAdvDecl *n) {
+	n->expr1 = visitExpr (n->expr1) ;
+	n->expr2 = visitExpr (n->expr2) ;
+	declare (n->varName1, matrixSymbol, "Matrix", n) ;
+	table.enterScope () ;
+	declare (n->varName2, indexSymbol, "Int", n) ;
+	declare (n->varName3, indexSymbol, "Int", n) ;
+	n->expr3 = visitExpr (n->expr3) ;
+	table.exitScope () ;
+	return n ;
+}
+
+Node *NameResolver::visitForStmt (ForStmt *n) {
+	visitChildren (n) ;
+	if (n->varName->symbol != noSymbol)
+		table.symbol (n->varName->symbol).loopVariable = true ;
+	return n ;
+}
+
+Node *NameResolver::visitFunctionCall (FunctionCall *n) {
+	VarName *f = n->varName ;
+	f->nameId = table.names.intern (f->lexeme) ;
+	f->symbol = table.lookup (f->nameId) ;
+	if (f->symbol == noSymbol || table.symbol (f->symbol).kind != functionSymbol)
+		f->symbol = table.declareFunction (f->nameId) ;
+	n->expr = visitExpr (n->expr) ;
+	return n ;
+}
+
+Node *NameResolver::visitVarName (VarName *n) {
+	n->nameId = table.names.intern (n->lexeme) ;
+	n->symbol = table.lookup (n->nameId) ;
+	if (n->symbol == noSymbol)
+		table.diagnostics.push_back (n->lexeme + " is not declared") ;
+	return n ;
+}
@@ -0,0 +1,118 @@
+/* symbolTable.h
+
+   This file declares [SymbolTable], which records the declarations of
+   a program, and [NameResolver], the pass that fills one in and points
+   each VarName at the declaration it refers to.
+
+   Names are interned in the table's StringPool, so a VarName's name is
+   an integer, and so is the Symbol it resolves to.  A Symbol's kind
+   tells a function, a scalar, a matrix and a matrix index variable
+   apart.
+
+   Scopes nest as in the C++ the program becomes: the body of main, a
+   StmtBlock, a LetExpr, and the initializer of a MatrixAdvDecl, in
+   which its two index variables are declared.  A declaration hides any
+   of the same name in an enclosing scope until its own scope ends.
+   Function names, which are never declared, go in the outermost scope
+   the first time they are called.
+
+   Lookup is by name id, through an array holding the innermost visible
+   Symbol of each name; each Symbol keeps the one it hides, to put back
+   when its scope ends.
+ */
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "AST.h"
+#include "stringPool.h"
+#include "visitor.h"
+
+typedef uint32_t SymbolId ;
+static const SymbolId noSymbol = VarName::unresolved ;
+
+enum symbolKindEnumType {
+	functionSymbol, scalarSymbol, matrixSymbol, indexSymbol
+} ;
+typedef enum symbolKindEnumType symbolKind ;
+
+struct Symbol {
+	uint32_t name ;         // id in the table's StringPool
+	symbolKind kind ;
+	std::string type ;      // "Int", "Float", "Str", "Bool", "Matrix", or "" for a function
+	int depth ;             // of the scope it is declared in; 0 is the outermost
+	bool loopVariable ;     // the variable of some ForStmt
+	Node *decl ;            // the declaring node, or NULL for a called function
+	SymbolId hidden ;       // the Symbol of the same name it hides, or noSymbol
+} ;
+
+class SymbolTable {
+public:
+	SymbolTable () { clear () ; }
+
+	StringPool names ;
+
+	void enterScope () ;
+	void exitScope () ;
+	int depth () const { return scopeStarts.size() - 1 ; }
+
+	// Declares [name] in the current scope.  A second declaration in
+	// the same scope is reported and replaces the first.
+	SymbolId declare (uint32_t name, symbolKind kind, const std::string &type, Node *decl) ;
+	// Declares [name] in the outermost scope, as a function.
+	SymbolId declareFunction (uint32_t name) ;
+
+	// The innermost visible Symbol named [name], or noSymbol.
+	SymbolId lookup (uint32_t name) const {
+		return name < visible.size() ? visible[name] : noSymbol ;
+	}
+
+	const Symbol &symbol (SymbolId id) const { return symbols[id] ; }
+	Symbol &symbol (SymbolId id) { return symbols[id] ; }
+	const char *nameOf (SymbolId id) const { return names.str (symbols[id].name) ; }
+	size_t size () const { return symbols.size() ; }
+
+	// Redeclarations and names used but not declared, in order.
+	std::vector<std::string> diagnostics ;
+
+	void clear () ;
+
+private:
+	std::vector<Symbol> symbols ;
+	std::vector<SymbolId> visible ;
+	// The Symbols of the open scopes, innermost last, and where each
+	// scope's Symbols start.
+	std::vector<SymbolId> scoped ;
+	std::vector<size_t> scopeStarts ;
+} ;
+
+/* Resolves every VarName of a tree against [table], which it clears
+   first.  The table keeps the Symbols after the pass, so later passes
+   can look at what a VarName's symbol id names.
+ */
+class NameResolver : public ASTVisitor, public Pass {
+public:
+	NameResolver (SymbolTable &t) : table(t) { }
+
+	const char *name () const { return "resolve-names" ; }
+	void run (Root *root) { visit (root) ; }
+
+	Node *visitRoot (Root *n) ;
+	Node *visitStmtBlock (StmtBlock *n) ;
+	Node *visitLetExpr (LetExpr *n) ;
+	Node *visitStandardDecl (StandardDecl *n) ;
+	Node *visitMatrixDecl (MatrixDecl *n) ;
+	Node *visitMatrixAdvDecl (MatrixAdvDecl *n) ;
+	Node *visitForStmt (ForStmt *n) ;
+	Node *visitFunctionCall (FunctionCall *n) ;
+	Node *visitVarName (VarName *n) ;
+
+private:
+	void declare (VarName *v, symbolKind kind, const std::string &type, Node *decl) ;
+	SymbolTable &table ;
+} ;
+
+#endif /* SYMBOLTABLE_H */
@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+#include "parser.h"
+#include "symbolTable.h"
+#include "readInput.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std ;
+
+// Collects the VarNames of a tree, in order.
+class NameCollector : public ConstASTVisitor {
+public:
+    vector<const VarName *> names ;
+    void visitVarName (const VarName *n) { names.push_back (n) ; }
+} ;
+
+class SymbolTableTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    Parser p ;
+    ParseResult pr ;
+    SymbolTable table ;
+
+    char **makeArgs ( const char *a0, const char *a1) {
+        char **aa = (char **) malloc (sizeof(char *) * 2) ;
+        aa[0] = (char *) malloc ( sizeof(char) * (strlen(a0) + 1) ) ;
+        strcpy (aa[0], a0 ) ;
+        aa[1] = (char *) malloc ( sizeof(char) * (strlen(a1) + 1) ) ;
+        strcpy (aa[1], a1 ) ;
+        return aa ;
+    }
+
+    vector<const VarName *> resolve ( const char *text ) {
+        pr = p.parse ( text ) ;
+        TS_ASSERT ( pr.ok ) ;
+        NameResolver r ( table ) ;
+        r.run ( pr.ast->asRoot() ) ;
+        NameCollector c ;
+        c.visit ( pr.ast ) ;
+        return c.names ;
+    }
+
+    void test_scopes ( void ) {
+        SymbolTable t ;
+        uint32_t x = t.names.intern ( "x" ) ;
+        TS_ASSERT_EQUALS ( t.lookup (x), noSymbol ) ;
+        t.enterScope () ;
+        SymbolId outer = t.declare ( x, scalarSymbol, "Int", NULL ) ;
+        t.enterScope () ;
+        SymbolId inner = t.declare ( x, scalarSymbol, "Float", NULL ) ;
+        TS_ASSERT_EQUALS ( t.lookup (x), inner ) ;
+        TS_ASSERT_EQUALS ( t.depth (), 2 ) ;
+        t.exitScope () ;
+        TS_ASSERT_EQUALS ( t.lookup (x), outer ) ;
+        t.exitScope () ;
+        TS_ASSERT_EQUALS ( t.lookup (x), noSymbol ) ;
+        TS_ASSERT ( t.diagnostics.empty () ) ;
+    }
+
+    // Each use of a name resolves to the innermost declaration, and
+    // the same name is the same integer everywhere.
+    void test_resolve_shadowing ( void ) {
+        vector<const VarName *> v = resolve (
+            "main () { Int x ; x = 1 ; "
+            "{ Float x ; x = 2.0 ; } "
+            "x = let Str x ; x = \"s\" ; in x end ; }" ) ;
+        // main, x, x, x, x, x, x, x, x
+        TS_ASSERT_EQUALS ( v.size (), 9u ) ;
+        TS_ASSERT ( table.diagnostics.empty () ) ;
+        for (size_t i = 2; i < v.size(); i ++)
+            TS_ASSERT_EQUALS ( v[i]->nameId, v[1]->nameId ) ;
+        TS_ASSERT_EQUALS ( v[2]->symbol, v[1]->symbol ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[3]->symbol).type, "Float" ) ;
+        TS_ASSERT_EQUALS ( v[4]->symbol, v[3]->symbol ) ;
+        TS_ASSERT_EQUALS ( v[5]->symbol, v[1]->symbol ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[6]->symbol).type, "Str" ) ;
+        TS_ASSERT_EQUALS ( v[7]->symbol, v[6]->symbol ) ;
+        TS_ASSERT_EQUALS ( v[8]->symbol, v[6]->symbol ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[0]->symbol).kind, functionSymbol ) ;
+    }
+
+    void test_resolve_kinds ( void ) {
+        vector<const VarName *> v = resolve (
+            "main () { Matrix m = readMatrix ( \"f\" ) ; Int k ; "
+            "Matrix n [ numRows(m), 2 ] i, j = m [ i, j ] ; "
+            "for ( k = 0 : 3 ) { print ( n [ k, k ] ) ; } }" ) ;
+        TS_ASSERT ( table.diagnostics.empty () ) ;
+        // main m readMatrix k n numRows m i j m i j k n k k
+        TS_ASSERT_EQUALS ( v.size (), 16u ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[1]->symbol).kind, matrixSymbol ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[2]->symbol).kind, functionSymbol ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[5]->symbol).kind, functionSymbol ) ;
+        TS_ASSERT_EQUALS ( v[6]->symbol, v[1]->symbol ) ;
+        TS_ASSERT_EQUALS ( v[9]->symbol, v[1]->symbol ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[7]->symbol).kind, indexSymbol ) ;
+        TS_ASSERT_EQUALS ( v[10]->symbol, v[7]->symbol ) ;
+        TS_ASSERT_EQUALS ( v[11]->symbol, v[8]->symbol ) ;
+        TS_ASSERT_EQUALS ( table.symbol (v[3]->symbol).kind, scalarSymbol ) ;
+        TS_ASSERT ( table.symbol (v[3]->symbol).loopVariable ) ;
+        TS_ASSERT ( ! table.symbol (v[7]->symbol).loopVariable ) ;
+        TS_ASSERT_EQUALS ( v[13]->symbol, v[4]->symbol ) ;
+    }
+
+    void test_resolve_errors ( void ) {
+        vector<const VarName *> v = resolve (
+            "main () { Int x ; Int x ; y = x ; { Int y ; } y = 1 ; }" ) ;
+        TS_ASSERT_EQUALS ( table.diagnostics.size (), 3u ) ;
+        TS_ASSERT_EQUALS ( table.diagnostics[0], "x is declared twice in the same scope" ) ;
+        TS_ASSERT_EQUALS ( table.diagnostics[1], "y is not declared" ) ;
+        TS_ASSERT_EQUALS ( table.diagnostics[2], "y is not declared" ) ;
+        TS_ASSERT_EQUALS ( v[3]->symbol, noSymbol ) ;
+        TS_ASSERT_EQUALS ( v[4]->symbol, v[2]->symbol ) ;
+    }
+
+    // Every name in the samples that have all their declarations
+    // resolves.
+    void test_resolve_samples ( void ) {
+        const char *files[] = { "sample_5.dsl", "my_sample_2.dsl", "forest_loss_v2.dsl" } ;
+        for (int i = 0; i < 3; i ++) {
+            string path = string("../samples/") + files[i] ;
+            pr = p.parse ( readInput (2, makeArgs("translator", path.c_str())) ) ;
+            TSM_ASSERT ( files[i], pr.ok ) ;
+            NameResolver r ( table ) ;
+            r.run ( pr.ast->asRoot() ) ;
+            TSM_ASSERT ( files[i], table.diagnostics.empty () ) ;
+            NameCollector c ;
+            c.visit ( pr.ast ) ;
+            for (size_t j = 0; j < c.names.size(); j ++)
+                TSM_ASSERT_DIFFERS ( files[i], c.names[j]->symbol, noSymbol ) ;
+        }
+    }
+} ;
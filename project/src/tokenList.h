@@ -0,0 +1,68 @@
+/* tokenList.h
+
+   This file lists every terminal of the language, in tokenType order,
+   with the regex the scanner matches it with and the description the
+   parser uses for it in error messages.  The tokenType enum in
+   scanner.h, the token patterns in scanner.cpp and the descriptions
+   are all expanded from this one list, so they cannot disagree.
+
+   TOKEN_LIST(T) expands to T(name, pattern, description) for each
+   terminal.  Patterns are POSIX extended regexes.
+ */
+#ifndef TOKENLIST_H
+#define TOKENLIST_H
+
+#define TOKEN_LIST(T) \
+	/* Keywords */ \
+	T(intKwd,			"^Int",						"'Int'") \
+	T(floatKwd,			"^Float",					"'Float'") \
+	T(boolKwd,			"^Bool",					"'Bool'") \
+	T(trueKwd,			"^True",					"true const") \
+	T(falseKwd,			"^False",					"false const") \
+	T(stringKwd,		"^Str",						"'Str'") \
+	T(matrixKwd,		"^Matrix",					"'Matrix'") \
+	T(letKwd,			"^let",						"'let'") \
+	T(inKwd,			"^in",						"'in'") \
+	T(endKwd,			"^end",						"'end'") \
+	T(ifKwd,			"^if",						"'if'") \
+	T(thenKwd,			"^then",					"'then'") \
+	T(elseKwd,			"^else",					"'else'") \
+	T(forKwd,			"^for",						"'for'") \
+	T(whileKwd,			"^while",					"'while'") \
+	T(printKwd,			"^print",					"'print'") \
+	/* Constants */ \
+	T(intConst,			"^[0-9]+",					"int const") \
+	T(floatConst,		"^[0-9]*\\.?[0-9]*",		"float const") \
+	T(stringConst,		"^\"(\\.|[^\"])*\"",		"string const") \
+	/* Names */ \
+	T(variableName,		"^[a-zA-Z_][a-zA-Z_0-9]*",	"variable name") \
+	/* Punctuation */ \
+	T(leftParen,		"^\\(",						"'('") \
+	T(rightParen,		"^)",						")") \
+	T(leftCurly,		"^\\{",						"{") \
+	T(rightCurly,		"^}",						"}") \
+	T(leftSquare,		"^\\[",						"[") \
+	T(rightSquare,		"^]",						"]") \
+	T(comma,			"^,",						",") \
+	T(semiColon,		"^;",						";") \
+	T(colon,			"^:",						":") \
+	/* Operators */ \
+	T(assign,			"^=",						"=") \
+	T(plusSign,			"^\\+",						"'+'") \
+	T(star,				"^\\*",						"'*'") \
+	T(dash,				"^-",						"'-'") \
+	T(forwardSlash,		"^/",						"/") \
+	T(lessThan,			"^<",						"<") \
+	T(lessThanEqual,	"^<=",						"<=") \
+	T(greaterThan,		"^>",						">") \
+	T(greaterThanEqual,	"^>=",						">=") \
+	T(equalsEquals,		"^==",						"==") \
+	T(notEquals,		"^!=",						"!=") \
+	T(andOp,			"^&&",						"&&") \
+	T(orOp,				"^\\|\\|",					"||") \
+	T(notOp,			"^!",						"notOp") \
+	/* Special terminal types */ \
+	T(endOfFile,		"^EOF",						"end of file") \
+	T(lexicalError,		"[^ ]",						"lexical error")
+
+#endif /* TOKENLIST_H */
@@ -0,0 +1,177 @@
+/* typeChecker.cpp
+
+   This file provides the [TypeChecker] pass.
+ */
+
+#include "typeChecker.h"
+
+using namespace std ;
+
+static bool isNumber (exprType t) {
+	return t == intType || t == floatType ;
+}
+
+// The functions a program may call, other than the methods of Matrix,
+// are those of math.h, on floats.
+static exprType resultOf (const string &function) {
+	if (function == "numRows" || function == "numCols")
+		return intType ;
+	if (function == "readMatrix")
+		return matrixType ;
+	static const char *mathFunctions[] = {
+		"ceil", "floor", "sqrt", "fabs", "exp", "log", "pow", "sin", "cos", "tan", NULL
+	} ;
+	for (int i = 0; mathFunctions[i] != NULL; i++)
+		if (function == mathFunctions[i])
+			return floatType ;
+	return unknownType ;
+}
+
+void TypeChecker::run (Root *root) {
+	symbolTypes.resize (table.size()) ;
+	for (SymbolId i = 0; i < table.size(); i++) {
+		const Symbol &s = table.symbol (i) ;
+		switch (s.kind) {
+		case functionSymbol: symbolTypes[i] = unknownType ; break ;
+		case indexSymbol: symbolTypes[i] = intType ; break ;
+		case matrixSymbol: symbolTypes[i] = matrixType ; break ;
+		case scalarSymbol: symbolTypes[i] = typeNamed (s.type) ; break ;
+		}
+	}
+	diagnostics.clear () ;
+	visit (root) ;
+}
+
+void TypeChecker::widenLiteral (Expr *e) {
+	if (e->type() != intType)
+		return ;
+	if (e->kind() == anyConstNode)
+		e->setType (floatType) ;
+	else if (e->kind() == parensExprNode) {
+		Expr *inner = static_cast<ParensExpr *>(e)->expr ;
+		widenLiteral (inner) ;
+		e->setType (inner->type()) ;
+	}
+}
+
+void TypeChecker::assignTo (exprType to, Expr *e, const string &target) {
+	if (to == floatType)
+		widenLiteral (e) ;
+	exprType from = e->type() ;
+	if (to == unknownType || from == unknownType || to == from)
+		return ;
+	// An Int and a Float convert to each other, as in C++.
+	if (isNumber (to) && isNumber (from))
+		return ;
+	diagnostics.push_back (string("cannot assign ") + typeSpelling (from) + " to " +
+	                       target + ", of type " + typeSpelling (to)) ;
+}
+
+Node *TypeChecker::visitMatrixAdvDecl (MatrixAdvDecl *n) {
+	visitChildren (n) ;
+	assignTo (floatType, n->expr3, n->varName1->lexeme) ;
+	return n ;
+}
+
+Node *TypeChecker::visitStandardAssignStmt (StandardAssignStmt *n) {
+	visitChildren (n) ;
+	assignTo (n->varName->type(), n->expr, n->varName->lexeme) ;
+	return n ;
+}
+
+Node *TypeChecker::visitMatrixAssignStmt (MatrixAssignStmt *n) {
+	visitChildren (n) ;
+	assignTo (floatType, n->expr3, n->varName->lexeme) ;
+	return n ;
+}
+
+Node *TypeChecker::visitVarName (VarName *n) {
+	if (n->symbol < symbolTypes.size())
+		n->setType (symbolTypes[n->symbol]) ;
+	return n ;
+}
+
+Node *TypeChecker::visitAnyConst (AnyConst *n) {
+	const string &s = n->constString ;
+	if (s.size() > 0 && s[0] == '"')
+		n->setType (strType) ;
+	else if (s == "True" || s == "False")
+		n->setType (boolType) ;
+	else if (s.find ('.') != string::npos)
+		n->setType (floatType) ;
+	else
+		n->setType (intType) ;
+	return n ;
+}
+
+Node *TypeChecker::visitBinOpExpr (BinOpExpr *n) {
+	visitChildren (n) ;
+	if (n->op == "&&" || n->op == "||") {
+		n->setType (boolType) ;
+		return n ;
+	}
+
+	binaryOp op = binaryOpNamed (n->op) ;
+	bool comparison = op >= lessOp && op < numBinaryOps ;
+	exprType l = n->left->type(), r = n->right->type() ;
+	exprType t = unknownType ;
+
+	if (isNumber (l) && isNumber (r)) {
+		if (l == floatType || r == floatType) {
+			widenLiteral (n->left) ;
+			widenLiteral (n->right) ;
+			t = floatType ;
+		} else
+			t = intType ;
+	} else if (l != unknownType && r != unknownType && ! (comparison && l == r))
+		diagnostics.push_back (string("operator ") + n->op + " cannot be applied to " +
+		                       typeSpelling (l) + " and " + typeSpelling (r)) ;
+
+	n->setType (comparison ? boolType : t) ;
+	return n ;
+}
+
+Node *TypeChecker::visitMatrixRefExpr (MatrixRefExpr *n) {
+	visitChildren (n) ;
+	n->setType (floatType) ;
+	return n ;
+}
+
+Node *TypeChecker::visitFunctionCall (FunctionCall *n) {
+	visitChildren (n) ;
+	n->setType (resultOf (n->varName->lexeme)) ;
+	return n ;
+}
+
+Node *TypeChecker::visitParensExpr (ParensExpr *n) {
+	visitChildren (n) ;
+	n->setType (n->expr->type()) ;
+	return n ;
+}
+
+Node *TypeChecker::visitLetExpr (LetExpr *n) {
+	visitChildren (n) ;
+	n->setType (n->expr->type()) ;
+	return n ;
+}
+
+Node *TypeChecker::visitIfExpr (IfExpr *n) {
+	visitChildren (n) ;
+	exprType t2 = n->expr2->type(), t3 = n->expr3->type() ;
+	if (t2 == t3)
+		n->setType (t2) ;
+	else if (isNumber (t2) && isNumber (t3)) {
+		widenLiteral (n->expr2) ;
+		widenLiteral (n->expr3) ;
+		n->setType (floatType) ;
+	} else if (t2 != unknownType && t3 != unknownType)
+		diagnostics.push_back (string("the branches of an if are ") +
+		                       typeSpelling (t2) + " and " + typeSpelling (t3)) ;
+	return n ;
+}
+
+Node *TypeChecker::visitNotExpr (NotExpr *n) {
+	visitChildren (n) ;
+	n->setType (boolType) ;
+	return n ;
+}
@@ -0,0 +1,69 @@
+/* typeChecker.h
+
+   This file declares [TypeChecker], the pass that gives every Expr of
+   a tree its exprType, after a NameResolver has run over it.
+
+   The rules are those of the C++ the program becomes:
+     - a name has the type it is declared with; an index variable of a
+       MatrixAdvDecl is an Int;
+     - an element of a matrix is a Float;
+     - +, -, * and / of two Ints is an Int, and of an Int and a Float,
+       or two Floats, a Float;
+     - comparisons, &&, || and ! are Bools;
+     - numRows and numCols are Ints, readMatrix a Matrix, and the
+       functions of math.h Floats.
+
+   Where an Int literal meets a Float -- as an operand, a branch of an
+   IfExpr, or the value put into a Float variable or a matrix element
+   -- the literal is made a Float, so that codegen writes a float
+   literal and the C++ compiler has no int, or double, to convert.
+   See AnyConst::emitCppCode.
+
+   Operands that cannot be used together, and values assigned to a
+   variable of another type, are reported in [diagnostics].
+ */
+#ifndef TYPECHECKER_H
+#define TYPECHECKER_H
+
+#include <string>
+#include <vector>
+
+#include "AST.h"
+#include "symbolTable.h"
+#include "visitor.h"
+
+class TypeChecker : public ASTVisitor, public Pass {
+public:
+	TypeChecker (const SymbolTable &t) : table(t) { }
+
+	const char *name () const { return "check-types" ; }
+	void run (Root *root) ;
+
+	Node *visitMatrixAdvDecl (MatrixAdvDecl *n) ;
+	Node *visitStandardAssignStmt (StandardAssignStmt *n) ;
+	Node *visitMatrixAssignStmt (MatrixAssignStmt *n) ;
+	Node *visitVarName (VarName *n) ;
+	Node *visitAnyConst (AnyConst *n) ;
+	Node *visitBinOpExpr (BinOpExpr *n) ;
+	Node *visitMatrixRefExpr (MatrixRefExpr *n) ;
+	Node *visitFunctionCall (FunctionCall *n) ;
+	Node *visitParensExpr (ParensExpr *n) ;
+	Node *visitLetExpr (LetExpr *n) ;
+	Node *visitIfExpr (IfExpr *n) ;
+	Node *visitNotExpr (NotExpr *n) ;
+
+	// Type errors, in order.
+	std::vector<std::string> diagnostics ;
+
+private:
+	// Makes [e] a Float if it is an Int literal, or one in parentheses.
+	void widenLiteral (Expr *e) ;
+	// Makes a literal of [e] a Float if it is to be stored as [to].
+	void assignTo (exprType to, Expr *e, const std::string &target) ;
+
+	const SymbolTable &table ;
+	// The exprType of each Symbol of [table].
+	std::vector<exprType> symbolTypes ;
+} ;
+
+#endif /* TYPECHECKER_H */
@@ -0,0 +1,110 @@
+#include <cxxtest/TestSuite.h>
+#include "parser.h"
+#include "typeChecker.h"
+#include "readInput.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std ;
+
+// Collects the types of the operator expressions of a tree, in order.
+class OperatorTypes : public ConstASTVisitor {
+public:
+    vector<exprType> types ;
+    void visitBinOpExpr (const BinOpExpr *n) { visitChildren (n) ; types.push_back (n->type()) ; }
+    void visitNotExpr (const NotExpr *n) { visitChildren (n) ; types.push_back (n->type()) ; }
+    void visitIfExpr (const IfExpr *n) { visitChildren (n) ; types.push_back (n->type()) ; }
+} ;
+
+class TypeCheckerTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    Parser p ;
+    ParseResult pr ;
+    SymbolTable table ;
+
+    char **makeArgs ( const char *a0, const char *a1) {
+        char **aa = (char **) malloc (sizeof(char *) * 2) ;
+        aa[0] = (char *) malloc ( sizeof(char) * (strlen(a0) + 1) ) ;
+        strcpy (aa[0], a0 ) ;
+        aa[1] = (char *) malloc ( sizeof(char) * (strlen(a1) + 1) ) ;
+        strcpy (aa[1], a1 ) ;
+        return aa ;
+    }
+
+    // Parses [text] and runs the NameResolver and TypeChecker over it.
+    vector<string> check ( const char *text ) {
+        pr = p.parse ( text ) ;
+        TS_ASSERT ( pr.ok ) ;
+        NameResolver names ( table ) ;
+        TypeChecker types ( table ) ;
+        names.run ( pr.ast->asRoot() ) ;
+        types.run ( pr.ast->asRoot() ) ;
+        return types.diagnostics ;
+    }
+
+    void test_types ( void ) {
+        TS_ASSERT ( check ( "main () { Int i ; Float f ; Matrix m [ 2, 2 ] r, c = r + c ; "
+                            "i = i / 2 ; f = f * i ; f = m [ i, 0 ] ; "
+                            "f = if ! ( i < 3 ) then 1 else f ; "
+                            "i = numRows ( m ) + 1 ; }" ).empty () ) ;
+        OperatorTypes o ;
+        o.visit ( pr.ast ) ;
+        // r + c, i / 2, f * i, i < 3, !, if, numRows + 1
+        TS_ASSERT_EQUALS ( o.types.size (), 7u ) ;
+        TS_ASSERT_EQUALS ( o.types[0], intType ) ;
+        TS_ASSERT_EQUALS ( o.types[1], intType ) ;
+        TS_ASSERT_EQUALS ( o.types[2], floatType ) ;
+        TS_ASSERT_EQUALS ( o.types[3], boolType ) ;
+        TS_ASSERT_EQUALS ( o.types[4], boolType ) ;
+        TS_ASSERT_EQUALS ( o.types[5], floatType ) ;
+        TS_ASSERT_EQUALS ( o.types[6], intType ) ;
+    }
+
+    // Literals that meet a Float are written as C++ floats; Int
+    // arithmetic is left alone.
+    void test_typed_literals ( void ) {
+        TS_ASSERT ( check ( "main () { Float f ; Int i ; Bool b ; "
+                            "f = 0 ; f = 0.0 - 25 ; i = 7 / 2 ; "
+                            "f = i * 1.0 / (7) ; b = True ; "
+                            "Matrix m [ 2, 2 ] r, c = 1 ; }" ).empty () ) ;
+        string code = pr.ast->cppCode () ;
+        TS_ASSERT ( code.find ( "float f;\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "f = 0.0f;\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "f = 0.0f - 25.0f;\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "i = 7 / 2;\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "f = i * 1.0f / (7.0f);\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "b = true;\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( ")) = 1.0f;\n" ) != string::npos ) ;
+    }
+
+    void test_type_errors ( void ) {
+        vector<string> d = check ( "main () { Int x ; Str s ; Bool b ; s = \"a\" ; "
+                                   "x = s ; x = s * 2 ; b = s < 1 ; "
+                                   "x = if b then 1 else s ; }" ) ;
+        TS_ASSERT_EQUALS ( d.size (), 4u ) ;
+        TS_ASSERT_EQUALS ( d[0], "cannot assign Str to x, of type Int" ) ;
+        TS_ASSERT_EQUALS ( d[1], "operator * cannot be applied to Str and Int" ) ;
+        TS_ASSERT_EQUALS ( d[2], "operator < cannot be applied to Str and Int" ) ;
+        TS_ASSERT_EQUALS ( d[3], "the branches of an if are Int and Str" ) ;
+    }
+
+    void test_forest_loss ( void ) {
+        pr = p.parse ( readInput (2, makeArgs("translator", "../samples/forest_loss_v2.dsl")) ) ;
+        TS_ASSERT ( pr.ok ) ;
+        NameResolver names ( table ) ;
+        TypeChecker types ( table ) ;
+        PassManager passes ;
+        passes.add ( &names ) ;
+        passes.add ( &types ) ;
+        passes.run ( pr.ast->asRoot() ) ;
+        TS_ASSERT ( types.diagnostics.empty () ) ;
+        string code = pr.ast->cppCode () ;
+        TS_ASSERT ( code.find ( "ceil(cols * 1.0f / season_length)" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "maximum = 0.0f - 25.0f;\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "diff = 0.0f;\n" ) != string::npos ) ;
+        TS_ASSERT ( code.find ( "0.0;" ) == string::npos ) ;
+    }
+} ;
@@ -0,0 +1,366 @@
+/* visitor.cpp
+
+   This file provides [ConstASTVisitor], [ASTVisitor] and [PassManager].
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <chrono>
+
+#include "visitor.h"
+
+using namespace std ;
+
+////////////////////////////////////////////////
+//
+//	ConstASTVisitor
+//
+////////////////////////////////////////////////
+
+void ConstASTVisitor::visit (const Node *n) {
+	switch (n->kind()) {
+	case rootNode: visitRoot (static_cast<const Root *>(n)) ; break ;
+	case stmtListNode: visitStmtList (static_cast<const StmtList *>(n)) ; break ;
+	case standardDeclNode: visitStandardDecl (static_cast<const StandardDecl *>(n)) ; break ;
+	case matrixAdvDeclNode: visitMatrixAdvDecl (static_cast<const MatrixAdvDecl *>(n)) ; break ;
+	case matrixDeclNode: visitMatrixDecl (static_cast<const MatrixDecl *>(n)) ; break ;
+	case stmtBlockNode: visitStmtBlock (static_cast<const StmtBlock *>(n)) ; break ;
+	case ifStmtNode: visitIfStmt (static_cast<const IfStmt *>(n)) ; break ;
+	case ifElseStmtNode: visitIfElseStmt (static_cast<const IfElseStmt *>(n)) ; break ;
+	case standardAssignStmtNode: visitStandardAssignStmt (static_cast<const StandardAssignStmt *>(n)) ; break ;
+	case matrixAssignStmtNode: visitMatrixAssignStmt (static_cast<const MatrixAssignStmt *>(n)) ; break ;
+	case printStmtNode: visitPrintStmt (static_cast<const PrintStmt *>(n)) ; break ;
+	case forStmtNode: visitForStmt (static_cast<const ForStmt *>(n)) ; break ;
+	case whileStmtNode: visitWhileStmt (static_cast<const WhileStmt *>(n)) ; break ;
+	case varNameNode: visitVarName (static_cast<const VarName *>(n)) ; break ;
+	case anyConstNode: visitAnyConst (static_cast<const AnyConst *>(n)) ; break ;
+	case binOpExprNode: visitBinOpExpr (static_cast<const BinOpExpr *>(n)) ; break ;
+	case matrixRefExprNode: visitMatrixRefExpr (static_cast<const MatrixRefExpr *>(n)) ; break ;
+	case functionCallNode: visitFunctionCall (static_cast<const FunctionCall *>(n)) ; break ;
+	case parensExprNode: visitParensExpr (static_cast<const ParensExpr *>(n)) ; break ;
+	case letExprNode: visitLetExpr (static_cast<const LetExpr *>(n)) ; break ;
+	case ifExprNode: visitIfExpr (static_cast<const IfExpr *>(n)) ; break ;
+	case notExprNode: visitNotExpr (static_cast<const NotExpr *>(n)) ; break ;
+	}
+}
+
+/* Children are visited in the order they appear in the program text,
+   so a pass sees a name declared before the code that uses it.
+ */
+void ConstASTVisitor::visitChildren (const Node *n) {
+	switch (n->kind()) {
+	case rootNode: {
+		const Root *r = static_cast<const Root *>(n) ;
+		visit (r->varName) ; visit (r->stmts) ;
+		break ; }
+	case stmtListNode: {
+		const StmtList *l = static_cast<const StmtList *>(n) ;
+		for (size_t i = 0; i < l->stmts.size(); i++)
+			visit (l->stmts[i]) ;
+		break ; }
+	case standardDeclNode:
+		visit (static_cast<const StandardDecl *>(n)->varName) ;
+		break ;
+	case matrixAdvDeclNode: {
+		const MatrixAdvDecl *d = static_cast<const MatrixAdvDecl *>(n) ;
+		visit (d->varName1) ; visit (d->expr1) ; visit (d->expr2) ;
+		visit (d->varName2) ; visit (d->varName3) ; visit (d->expr3) ;
+		break ; }
+	case matrixDeclNode: {
+		const MatrixDecl *d = static_cast<const MatrixDecl *>(n) ;
+		visit (d->varName) ; visit (d->expr) ;
+		break ; }
+	case stmtBlockNode:
+		visit (static_cast<const StmtBlock *>(n)->stmts) ;
+		break ;
+	case ifStmtNode: {
+		const IfStmt *s = static_cast<const IfStmt *>(n) ;
+		visit (s->expr) ; visit (s->stmt) ;
+		break ; }
+	case ifElseStmtNode: {
+		const IfElseStmt *s = static_cast<const IfElseStmt *>(n) ;
+		visit (s->expr) ; visit (s->stmt1) ; visit (s->stmt2) ;
+		break ; }
+	case standardAssignStmtNode: {
+		const StandardAssignStmt *s = static_cast<const StandardAssignStmt *>(n) ;
+		visit (s->varName) ; visit (s->expr) ;
+		break ; }
+	case matrixAssignStmtNode: {
+		const MatrixAssignStmt *s = static_cast<const MatrixAssignStmt *>(n) ;
+		visit (s->varName) ; visit (s->expr1) ; visit (s->expr2) ; visit (s->expr3) ;
+		break ; }
+	case printStmtNode:
+		visit (static_cast<const PrintStmt *>(n)->expr) ;
+		break ;
+	case forStmtNode: {
+		const ForStmt *s = static_cast<const ForStmt *>(n) ;
+		visit (s->varName) ; visit (s->expr1) ; visit (s->expr2) ; visit (s->stmt) ;
+		break ; }
+	case whileStmtNode: {
+		const WhileStmt *s = static_cast<const WhileStmt *>(n) ;
+		visit (s->expr) ; visit (s->stmt) ;
+		break ; }
+	case varNameNode:
+	case anyConstNode:
+		break ;
+	case binOpExprNode: {
+		const BinOpExpr *e = static_cast<const BinOpExpr *>(n) ;
+		if (e == leftVisited)
+			leftVisited = NULL ;
+		else
+			visitLeft (e) ;
+		visit (e->right) ;
+		break ; }
+	case matrixRefExprNode: {
+		const MatrixRefExpr *e = static_cast<const MatrixRefExpr *>(n) ;
+		visit (e->varName) ; visit (e->expr1) ; visit (e->expr2) ;
+		break ; }
+	case functionCallNode: {
+		const FunctionCall *e = static_cast<const FunctionCall *>(n) ;
+		visit (e->varName) ; visit (e->expr) ;
+		break ; }
+	case parensExprNode:
+		visit (static_cast<const ParensExpr *>(n)->expr) ;
+		break ;
+	case letExprNode: {
+		const LetExpr *e = static_cast<const LetExpr *>(n) ;
+		visit (e->stmts) ; visit (e->expr) ;
+		break ; }
+	case ifExprNode: {
+		const IfExpr *e = static_cast<const IfExpr *>(n) ;
+		visit (e->expr1) ; visit (e->expr2) ; visit (e->expr3) ;
+		break ; }
+	case notExprNode:
+		visit (static_cast<const NotExpr *>(n)->expr) ;
+		break ;
+	}
+}
+
+/* Visits the left operand of [e] with a loop down the chain of
+   BinOpExprs it may start, rather than by recursion; see visitor.h.
+   [leftVisited] is saved and restored, since a right operand visited
+   on the way may hold a chain of its own.
+ */
+void ConstASTVisitor::visitLeft (const BinOpExpr *e) {
+	const BinOpExpr *saved = leftVisited ;
+	vector<const BinOpExpr *> spine ;
+	const Expr *x = e->left ;
+	while (x->kind() == binOpExprNode) {
+		spine.push_back (static_cast<const BinOpExpr *>(x)) ;
+		x = spine.back()->left ;
+	}
+	visit (x) ;
+	for (size_t i = spine.size(); i-- > 0; ) {
+		leftVisited = spine[i] ;
+		visit (spine[i]) ;
+	}
+	leftVisited = saved ;
+}
+
+////////////////////////////////////////////////
+//
+//	ASTVisitor
+//
+////////////////////////////////////////////////
+
+Node *ASTVisitor::visit (Node *n) {
+	switch (n->kind()) {
+	case rootNode: return visitRoot (static_cast<Root *>(n)) ;
+	case stmtListNode: return visitStmtList (static_cast<StmtList *>(n)) ;
+	case standardDeclNode: return visitStandardDecl (static_cast<StandardDecl *>(n)) ;
+	case matrixAdvDeclNode: return visitMatrixAdvDecl (static_cast<MatrixAdvDecl *>(n)) ;
+	case matrixDeclNode: return visitMatrixDecl (static_cast<MatrixDecl *>(n)) ;
+	case stmtBlockNode: return visitStmtBlock (static_cast<StmtBlock *>(n)) ;
+	case ifStmtNode: return visitIfStmt (static_cast<IfStmt *>(n)) ;
+	case ifElseStmtNode: return visitIfElseStmt (static_cast<IfElseStmt *>(n)) ;
+	case standardAssignStmtNode: return visitStandardAssignStmt (static_cast<StandardAssignStmt *>(n)) ;
+	case matrixAssignStmtNode: return visitMatrixAssignStmt (static_cast<MatrixAssignStmt *>(n)) ;
+	case printStmtNode: return visitPrintStmt (static_cast<PrintStmt *>(n)) ;
+	case forStmtNode: return visitForStmt (static_cast<ForStmt *>(n)) ;
+	case whileStmtNode: return visitWhileStmt (static_cast<WhileStmt *>(n)) ;
+	case varNameNode: return visitVarName (static_cast<VarName *>(n)) ;
+	case anyConstNode: return visitAnyConst (static_cast<AnyConst *>(n)) ;
+	case binOpExprNode: return visitBinOpExpr (static_cast<BinOpExpr *>(n)) ;
+	case matrixRefExprNode: return visitMatrixRefExpr (static_cast<MatrixRefExpr *>(n)) ;
+	case functionCallNode: return visitFunctionCall (static_cast<FunctionCall *>(n)) ;
+	case parensExprNode: return visitParensExpr (static_cast<ParensExpr *>(n)) ;
+	case letExprNode: return visitLetExpr (static_cast<LetExpr *>(n)) ;
+	case ifExprNode: return visitIfExpr (static_cast<IfExpr *>(n)) ;
+	case notExprNode: return visitNotExpr (static_cast<NotExpr *>(n)) ;
+	}
+	return n ;
+}
+
+Expr *ASTVisitor::visitExpr (Expr *e) {
+	Node *n = e->kind() == varNameNode ? visitVarUse (static_cast<VarName *>(e)) : visit (e) ;
+	Expr *r = n->asExpr() ;
+	assert (r != NULL) ;
+	return r ;
+}
+
+Stmt *ASTVisitor::visitStmt (Stmt *s) {
+	Stmt *r = visit (s)->asStmt() ;
+	assert (r != NULL) ;
+	return r ;
+}
+
+Stmts *ASTVisitor::visitStmts (Stmts *s) {
+	Stmts *r = visit (s)->asStmts() ;
+	assert (r != NULL) ;
+	return r ;
+}
+
+VarName *ASTVisitor::visitName (VarName *v) {
+	VarName *r = visit (v)->asVarName() ;
+	assert (r != NULL) ;
+	return r ;
+}
+
+// In the same order as ConstASTVisitor::visitChildren.
+void ASTVisitor::visitChildren (Node *n) {
+	switch (n->kind()) {
+	case rootNode: {
+		Root *r = static_cast<Root *>(n) ;
+		r->varName = visitName (r->varName) ; r->stmts = visitStmts (r->stmts) ;
+		break ; }
+	case stmtListNode: {
+		StmtList *l = static_cast<StmtList *>(n) ;
+		for (size_t i = 0; i < l->stmts.size(); i++)
+			l->stmts[i] = visitStmt (l->stmts[i]) ;
+		break ; }
+	case standardDeclNode: {
+		StandardDecl *d = static_cast<StandardDecl *>(n) ;
+		d->varName = visitName (d->varName) ;
+		break ; }
+	case matrixAdvDeclNode: {
+		MatrixAdvDecl *d = static_cast<MatrixAdvDecl *>(n) ;
+		d->varName1 = visitName (d->varName1) ;
+		d->expr1 = visitExpr (d->expr1) ; d->expr2 = visitExpr (d->expr2) ;
+		d->varName2 = visitName (d->varName2) ; d->varName3 = visitName (d->varName3) ;
+		d->expr3 = visitExpr (d->expr3) ;
+		break ; }
+	case matrixDeclNode: {
+		MatrixDecl *d = static_cast<MatrixDecl *>(n) ;
+		d->varName = visitName (d->varName) ; d->expr = visitExpr (d->expr) ;
+		break ; }
+	case stmtBlockNode: {
+		StmtBlock *s = static_cast<StmtBlock *>(n) ;
+		s->stmts = visitStmts (s->stmts) ;
+		break ; }
+	case ifStmtNode: {
+		IfStmt *s = static_cast<IfStmt *>(n) ;
+		s->expr = visitExpr (s->expr) ; s->stmt = visitStmt (s->stmt) ;
+		break ; }
+	case ifElseStmtNode: {
+		IfElseStmt *s = static_cast<IfElseStmt *>(n) ;
+		s->expr = visitExpr (s->expr) ;
+		s->stmt1 = visitStmt (s->stmt1) ; s->stmt2 = visitStmt (s->stmt2) ;
+		break ; }
+	case standardAssignStmtNode: {
+		StandardAssignStmt *s = static_cast<StandardAssignStmt *>(n) ;
+		s->varName = visitName (s->varName) ; s->expr = visitExpr (s->expr) ;
+		break ; }
+	case matrixAssignStmtNode: {
+		MatrixAssignStmt *s = static_cast<MatrixAssignStmt *>(n) ;
+		s->varName = visitName (s->varName) ;
+		s->expr1 = visitExpr (s->expr1) ; s->expr2 = visitExpr (s->expr2) ;
+		s->expr3 = visitExpr (s->expr3) ;
+		break ; }
+	case printStmtNode: {
+		PrintStmt *s = static_cast<PrintStmt *>(n) ;
+		s->expr = visitExpr (s->expr) ;
+		break ; }
+	case forStmtNode: {
+		ForStmt *s = static_cast<ForStmt *>(n) ;
+		s->varName = visitName (s->varName) ;
+		s->expr1 = visitExpr (s->expr1) ; s->expr2 = visitExpr (s->expr2) ;
+		s->stmt = visitStmt (s->stmt) ;
+		break ; }
+	case whileStmtNode: {
+		WhileStmt *s = static_cast<WhileStmt *>(n) ;
+		s->expr = visitExpr (s->expr) ; s->stmt = visitStmt (s->stmt) ;
+		break ; }
+	case varNameNode:
+	case anyConstNode:
+		break ;
+	case binOpExprNode: {
+		BinOpExpr *e = static_cast<BinOpExpr *>(n) ;
+		if (e == leftVisited)
+			leftVisited = NULL ;
+		else
+			visitLeft (e) ;
+		e->right = visitExpr (e->right) ;
+		break ; }
+	case matrixRefExprNode: {
+		MatrixRefExpr *e = static_cast<MatrixRefExpr *>(n) ;
+		e->varName = visitName (e->varName) ;
+		e->expr1 = visitExpr (e->expr1) ; e->expr2 = visitExpr (e->expr2) ;
+		break ; }
+	case functionCallNode: {
+		FunctionCall *e = static_cast<FunctionCall *>(n) ;
+		e->varName = visitName (e->varName) ; e->expr = visitExpr (e->expr) ;
+		break ; }
+	case parensExprNode: {
+		ParensExpr *e = static_cast<ParensExpr *>(n) ;
+		e->expr = visitExpr (e->expr) ;
+		break ; }
+	case letExprNode: {
+		LetExpr *e = static_cast<LetExpr *>(n) ;
+		e->stmts = visitStmts (e->stmts) ; e->expr = visitExpr (e->expr) ;
+		break ; }
+	case ifExprNode: {
+		IfExpr *e = static_cast<IfExpr *>(n) ;
+		e->expr1 = visitExpr (e->expr1) ; e->expr2 = visitExpr (e->expr2) ;
+		e->expr3 = visitExpr (e->expr3) ;
+		break ; }
+	case notExprNode: {
+		NotExpr *e = static_cast<NotExpr *>(n) ;
+		e->expr = visitExpr (e->expr) ;
+		break ; }
+	}
+}
+
+// As ConstASTVisitor::visitLeft, storing each replacement in the
+// BinOpExpr above it.
+void ASTVisitor::visitLeft (BinOpExpr *e) {
+	BinOpExpr *saved = leftVisited ;
+	vector<BinOpExpr *> spine ;
+	Expr *x = e->left ;
+	while (x->kind() == binOpExprNode) {
+		spine.push_back (static_cast<BinOpExpr *>(x)) ;
+		x = spine.back()->left ;
+	}
+	(spine.empty() ? e : spine.back())->left = visitExpr (x) ;
+	for (size_t i = spine.size(); i-- > 0; ) {
+		leftVisited = spine[i] ;
+		(i == 0 ? e : spine[i-1])->left = visitExpr (spine[i]) ;
+	}
+	leftVisited = saved ;
+}
+
+////////////////////////////////////////////////
+//
+//	PassManager
+//
+////////////////////////////////////////////////
+
+void PassManager::run (Root *root) {
+	times.clear () ;
+	for (size_t i = 0; i < passes.size(); i++) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now () ;
+		passes[i]->run (root) ;
+		chrono::duration<double> took = chrono::steady_clock::now () - start ;
+		Timing t = { passes[i]->name (), took.count () } ;
+		times.push_back (t) ;
+	}
+}
+
+string PassManager::report () const {
+	string s ;
+	char line[128] ;
+	for (size_t i = 0; i < times.size(); i++) {
+		snprintf (line, sizeof line, "%-24s %10.3f ms\n", times[i].name, times[i].seconds * 1000) ;
+		s += line ;
+	}
+	return s ;
+}
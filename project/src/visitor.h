@@ -0,0 +1,164 @@
+/* visitor.h
+
+   This file declares the classes for writing passes over the AST:
+
+   [ConstASTVisitor] walks a tree without changing it.  It has one
+   visit method per Node class; each one, unless overridden, visits the
+   node's children in order.  A pass overrides the methods for the
+   classes it cares about and calls visitChildren where it wants to go
+   on down.
+
+   [ASTVisitor] may change the tree.  Each of its visit methods returns
+   the node to put in the place of the one visited: the node itself,
+   or a new one made in the Parser's arena.  The default visits the
+   children and stores what each visit returns back into the node.
+
+   [PassManager] runs a list of [Pass]es over a Root, in order, and
+   records how long each one took.
+
+   Both visitors dispatch on Node::kind() with a switch, so adding a
+   pass needs no change to the Node classes.
+
+   They recurse once per level of nesting, which a Parser bounds with
+   its maxDepth.  A list of statements is walked with a loop, and so
+   is a chain of operators such as a + b + c, whose left operands are
+   BinOpExprs in turn: visitChildren of its top BinOpExpr visits the
+   operand at the bottom of the chain, then calls the visit method of
+   each BinOpExpr above it, from the bottom up, whose visitChildren
+   then visits just its right operand.  The visit methods are called
+   in the same order as by recursion, but work an override of
+   visitBinOpExpr does before calling visitChildren is done after its
+   left operand has been visited.  An override should reach the left
+   operand through visitChildren, not visit, to keep that.
+ */
+#ifndef VISITOR_H
+#define VISITOR_H
+
+#include <string>
+#include <vector>
+
+#include "AST.h"
+
+class ConstASTVisitor {
+public:
+	ConstASTVisitor () : leftVisited(NULL) { }
+	virtual ~ConstASTVisitor () { }
+
+	// Calls the visit method for the class of [n].
+	void visit (const Node *n) ;
+	// Visits the children of [n], in order.
+	void visitChildren (const Node *n) ;
+
+	virtual void visitRoot (const Root *n) { visitChildren (n) ; }
+	virtual void visitStmtList (const StmtList *n) { visitChildren (n) ; }
+	virtual void visitStandardDecl (const StandardDecl *n) { visitChildren (n) ; }
+	virtual void visitMatrixAdvDecl (const MatrixAdvDecl *n) { visitChildren (n) ; }
+	virtual void visitMatrixDecl (const MatrixDecl *n) { visitChildren (n) ; }
+	virtual void visitStmtBlock (const StmtBlock *n) { visitChildren (n) ; }
+	virtual void visitIfStmt (const IfStmt *n) { visitChildren (n) ; }
+	virtual void visitIfElseStmt (const IfElseStmt *n) { visitChildren (n) ; }
+	virtual void visitStandardAssignStmt (const StandardAssignStmt *n) { visitChildren (n) ; }
+	virtual void visitMatrixAssignStmt (const MatrixAssignStmt *n) { visitChildren (n) ; }
+	virtual void visitPrintStmt (const PrintStmt *n) { visitChildren (n) ; }
+	virtual void visitForStmt (const ForStmt *n) { visitChildren (n) ; }
+	virtual void visitWhileStmt (const WhileStmt *n) { visitChildren (n) ; }
+	virtual void visitVarName (const VarName *n) { }
+	virtual void visitAnyConst (const AnyConst *n) { }
+	virtual void visitBinOpExpr (const BinOpExpr *n) { visitChildren (n) ; }
+	virtual void visitMatrixRefExpr (const MatrixRefExpr *n) { visitChildren (n) ; }
+	virtual void visitFunctionCall (const FunctionCall *n) { visitChildren (n) ; }
+	virtual void visitParensExpr (const ParensExpr *n) { visitChildren (n) ; }
+	virtual void visitLetExpr (const LetExpr *n) { visitChildren (n) ; }
+	virtual void visitIfExpr (const IfExpr *n) { visitChildren (n) ; }
+	virtual void visitNotExpr (const NotExpr *n) { visitChildren (n) ; }
+
+private:
+	void visitLeft (const BinOpExpr *e) ;
+	// The BinOpExpr whose left operand visitLeft has visited.
+	const BinOpExpr *leftVisited ;
+} ;
+
+class ASTVisitor {
+public:
+	ASTVisitor () : leftVisited(NULL) { }
+	virtual ~ASTVisitor () { }
+
+	// Calls the visit method for the class of [n] and returns the node
+	// to replace it with.
+	Node *visit (Node *n) ;
+	// Visits the children of [n], in order, replacing each with the
+	// node its visit returns.
+	void visitChildren (Node *n) ;
+
+	virtual Node *visitRoot (Root *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitStmtList (StmtList *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitStandardDecl (StandardDecl *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitMatrixAdvDecl (MatrixAdvDecl *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitMatrixDecl (MatrixDecl *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitStmtBlock (StmtBlock *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitIfStmt (IfStmt *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitIfElseStmt (IfElseStmt *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitStandardAssignStmt (StandardAssignStmt *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitMatrixAssignStmt (MatrixAssignStmt *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitPrintStmt (PrintStmt *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitForStmt (ForStmt *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitWhileStmt (WhileStmt *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitVarName (VarName *n) { return n ; }
+	virtual Node *visitAnyConst (AnyConst *n) { return n ; }
+	virtual Node *visitBinOpExpr (BinOpExpr *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitMatrixRefExpr (MatrixRefExpr *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitFunctionCall (FunctionCall *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitParensExpr (ParensExpr *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitLetExpr (LetExpr *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitIfExpr (IfExpr *n) { visitChildren (n) ; return n ; }
+	virtual Node *visitNotExpr (NotExpr *n) { visitChildren (n) ; return n ; }
+
+	// A VarName that is a child Expr, used for its value, rather than
+	// one that is declared, assigned to or called.  It may be replaced
+	// by any Expr; visitVarName only by a VarName.
+	virtual Node *visitVarUse (VarName *n) { return visitVarName (n) ; }
+
+protected:
+	// Visits a child, checking that its replacement is of a class that
+	// may stand in that place.
+	Expr *visitExpr (Expr *e) ;
+	Stmt *visitStmt (Stmt *s) ;
+	Stmts *visitStmts (Stmts *s) ;
+	VarName *visitName (VarName *v) ;
+
+private:
+	void visitLeft (BinOpExpr *e) ;
+	BinOpExpr *leftVisited ;
+} ;
+
+class Pass {
+public:
+	virtual ~Pass () { }
+	virtual const char *name () const = 0 ;
+	virtual void run (Root *root) = 0 ;
+} ;
+
+class PassManager {
+public:
+	// Adds [p] to the end of the pipeline.  The PassManager does not
+	// own it.
+	void add (Pass *p) { passes.push_back (p) ; }
+
+	// Runs every pass over [root], in order, timing each one.
+	void run (Root *root) ;
+
+	struct Timing {
+		const char *name ;
+		double seconds ;
+	} ;
+	// The times of the last run, one for each pass, in order.
+	const std::vector<Timing> &timings () const { return times ; }
+	// The timings as text, one pass per line.
+	std::string report () const ;
+
+private:
+	std::vector<Pass *> passes ;
+	std::vector<Timing> times ;
+} ;
+
+#endif /* VISITOR_H */
@@ -0,0 +1,160 @@
+#include <cxxtest/TestSuite.h>
+#include "parser.h"
+#include "visitor.h"
+#include "readInput.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std ;
+
+// Counts the nodes of each kind.
+class KindCounter : public ConstASTVisitor {
+public:
+    KindCounter () { memset (counts, 0, sizeof counts) ; total = 0 ; }
+    int counts[notExprNode+1] ;
+    int total ;
+
+    void count (const Node *n) { counts[n->kind()] ++ ; total ++ ; }
+
+    void visitRoot (const Root *n) { count (n) ; visitChildren (n) ; }
+    void visitStmtList (const StmtList *n) { count (n) ; visitChildren (n) ; }
+    void visitStandardDecl (const StandardDecl *n) { count (n) ; visitChildren (n) ; }
+    void visitMatrixAdvDecl (const MatrixAdvDecl *n) { count (n) ; visitChildren (n) ; }
+    void visitMatrixDecl (const MatrixDecl *n) { count (n) ; visitChildren (n) ; }
+    void visitStmtBlock (const StmtBlock *n) { count (n) ; visitChildren (n) ; }
+    void visitIfStmt (const IfStmt *n) { count (n) ; visitChildren (n) ; }
+    void visitIfElseStmt (const IfElseStmt *n) { count (n) ; visitChildren (n) ; }
+    void visitStandardAssignStmt (const StandardAssignStmt *n) { count (n) ; visitChildren (n) ; }
+    void visitMatrixAssignStmt (const MatrixAssignStmt *n) { count (n) ; visitChildren (n) ; }
+    void visitPrintStmt (const PrintStmt *n) { count (n) ; visitChildren (n) ; }
+    void visitForStmt (const ForStmt *n) { count (n) ; visitChildren (n) ; }
+    void visitWhileStmt (const WhileStmt *n) { count (n) ; visitChildren (n) ; }
+    void visitVarName (const VarName *n) { count (n) ; }
+    void visitAnyConst (const AnyConst *n) { count (n) ; }
+    void visitBinOpExpr (const BinOpExpr *n) { count (n) ; visitChildren (n) ; }
+    void visitMatrixRefExpr (const MatrixRefExpr *n) { count (n) ; visitChildren (n) ; }
+    void visitFunctionCall (const FunctionCall *n) { count (n) ; visitChildren (n) ; }
+    void visitParensExpr (const ParensExpr *n) { count (n) ; visitChildren (n) ; }
+    void visitLetExpr (const LetExpr *n) { count (n) ; visitChildren (n) ; }
+    void visitIfExpr (const IfExpr *n) { count (n) ; visitChildren (n) ; }
+    void visitNotExpr (const NotExpr *n) { count (n) ; visitChildren (n) ; }
+} ;
+
+// Replaces each parenthesized expression with the expression inside.
+class DropParens : public ASTVisitor, public Pass {
+public:
+    const char *name () const { return "drop-parens" ; }
+    void run (Root *root) { visit (root) ; }
+
+    Node *visitParensExpr (ParensExpr *n) { return visit (n->expr) ; }
+} ;
+
+// Writes the names and operators of an expression in postfix order.
+class Postfix : public ConstASTVisitor {
+public:
+    string text ;
+    void visitVarName (const VarName *n) { text += n->lexeme + " " ; }
+    void visitBinOpExpr (const BinOpExpr *n) { visitChildren (n) ; text += n->op + " " ; }
+} ;
+
+// Counts the nodes left, as a second pass.
+class CountPass : public Pass {
+public:
+    KindCounter counter ;
+    const char *name () const { return "count" ; }
+    void run (Root *root) { counter.visit (root) ; }
+} ;
+
+class VisitorTestSuite : public CxxTest::TestSuite
+{
+public:
+
+    Parser p ;
+    ParseResult pr ;
+
+    char **makeArgs ( const char *a0, const char *a1) {
+        char **aa = (char **) malloc (sizeof(char *) * 2) ;
+        aa[0] = (char *) malloc ( sizeof(char) * (strlen(a0) + 1) ) ;
+        strcpy (aa[0], a0 ) ;
+        aa[1] = (char *) malloc ( sizeof(char) * (strlen(a1) + 1) ) ;
+        strcpy (aa[1], a1 ) ;
+        return aa ;
+    }
+
+    void test_count_kinds ( void ) {
+        pr = p.parse ( "main () { Int x ; x = (1 + x) * 2 ; "
+                       "if ( x < 3 ) { print ( x ) ; } }" ) ;
+        TS_ASSERT ( pr.ok ) ;
+        KindCounter k ;
+        k.visit ( pr.ast ) ;
+        TS_ASSERT_EQUALS ( k.counts[rootNode], 1 ) ;
+        TS_ASSERT_EQUALS ( k.counts[stmtListNode], 2 ) ;
+        TS_ASSERT_EQUALS ( k.counts[varNameNode], 6 ) ;
+        TS_ASSERT_EQUALS ( k.counts[anyConstNode], 3 ) ;
+        TS_ASSERT_EQUALS ( k.counts[binOpExprNode], 3 ) ;
+        TS_ASSERT_EQUALS ( k.counts[parensExprNode], 1 ) ;
+        TS_ASSERT_EQUALS ( k.counts[printStmtNode], 1 ) ;
+        TS_ASSERT_EQUALS ( k.total, 21 ) ;
+    }
+
+    // The visitor walks each sample from the Root down to its names.
+    void test_count_samples ( void ) {
+        const char *files[] = { "sample_1.dsl", "sample_3.dsl", "sample_5.dsl",
+                                "forest_loss_v2.dsl" } ;
+        for (int i = 0; i < 4; i ++) {
+            string path = string("../samples/") + files[i] ;
+            pr = p.parse ( readInput (2, makeArgs("translator", path.c_str())) ) ;
+            TSM_ASSERT ( files[i], pr.ok ) ;
+            KindCounter k ;
+            k.visit ( pr.ast ) ;
+            TSM_ASSERT_EQUALS ( files[i], k.counts[rootNode], 1 ) ;
+            TSM_ASSERT ( files[i], k.counts[varNameNode] > 1 ) ;
+            TSM_ASSERT ( files[i], k.total > k.counts[varNameNode] ) ;
+        }
+    }
+
+    // A chain of operators is walked with a loop, in the same order
+    // as recursion would walk it, and its operands can be replaced.
+    void test_chain ( void ) {
+        pr = p.parse ( "main () { x = (a) - (b) + c * (d) - ((e)) ; }" ) ;
+        TS_ASSERT ( pr.ok ) ;
+        DropParens d ;
+        d.visit ( pr.ast ) ;
+        TS_ASSERT_EQUALS ( pr.ast->unparse(), "main () {\nx = a - b + c * d - e;\n}\n" ) ;
+        Postfix o ;
+        o.visit ( pr.ast ) ;
+        TS_ASSERT_EQUALS ( o.text, "main x a b - c d * + e - " ) ;
+    }
+
+    void test_rewrite ( void ) {
+        pr = p.parse ( "main () { x = ((1 + (y))) * 2 ; print ( (x) ) ; }" ) ;
+        TS_ASSERT ( pr.ok ) ;
+        DropParens d ;
+        Node *n = d.visit ( pr.ast ) ;
+        TS_ASSERT_EQUALS ( n, pr.ast ) ;
+        TS_ASSERT_EQUALS ( pr.ast->unparse(),
+                           "main () {\nx = 1 + y * 2;\nprint(x);\n}\n" ) ;
+    }
+
+    void test_pass_manager ( void ) {
+        pr = p.parse ( "main () { x = (1) ; y = ((x)) ; }" ) ;
+        TS_ASSERT ( pr.ok ) ;
+        DropParens d ;
+        CountPass c ;
+        PassManager pm ;
+        pm.add ( &d ) ;
+        pm.add ( &c ) ;
+        pm.run ( pr.ast->asRoot() ) ;
+
+        TS_ASSERT_EQUALS ( c.counter.counts[parensExprNode], 0 ) ;
+        TS_ASSERT_EQUALS ( c.counter.counts[varNameNode], 4 ) ;
+        TS_ASSERT_EQUALS ( pm.timings().size(), 2u ) ;
+        TS_ASSERT_EQUALS ( string(pm.timings()[0].name), "drop-parens" ) ;
+        TS_ASSERT_EQUALS ( string(pm.timings()[1].name), "count" ) ;
+        TS_ASSERT ( pm.timings()[0].seconds >= 0 ) ;
+        string report = pm.report () ;
+        TS_ASSERT ( report.find ("drop-parens") == 0 ) ;
+        TS_ASSERT ( report.find ("\ncount") != string::npos ) ;
+    }
+} ;